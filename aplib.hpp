@@ -206,10 +206,10 @@ namespace aplib {
                     option.flag = &flag;
 
                     // Check with all the arguments with current flag
-                    for (size_t a = 0; a < flag.additional_arguments.size() && i < args[i].size() - a - 1; a++)
+                    for (size_t a = 0; a < flag.additional_arguments.size() && i + 1 < args.size(); a++)
                     {
                         // Skip argument if it seems as a flag
-                        if (a >= flag.additional_arguments.size() - flag.optional_arguments_count && is_flag(args[i]) != flag_type::unknown)
+                        if (a >= flag.additional_arguments.size() - flag.optional_arguments_count && is_flag(args[i + 1]) != flag_type::unknown)
                         {
                             break;
                         }
@@ -490,7 +490,7 @@ namespace aplib {
 
             inline void open(const std::string &filename)
             {
-                istream.open(filename);
+                istream.open(filename, std::ios::binary);
             }
 
             inline bool fail()
@@ -504,12 +504,24 @@ namespace aplib {
             }
 
             // Read size_t bytes for size of the raw data, and then read the raw data
+            // A size bigger than what's left in the file fails the stream instead of allocating it
             inline void read(std::vector<std::byte> &data)
             {
                 size_t size = 0;
+                data.clear();
                 if (!istream.eof()) istream.read((char *)&size, sizeof(size));
+                if (!istream) return;
+                std::streampos here = istream.tellg();
+                istream.seekg(0, std::ios::end);
+                std::streamoff left = istream.tellg() - here;
+                istream.seekg(here);
+                if (left < 0 || size > (size_t)left)
+                {
+                    istream.setstate(std::ios::failbit);
+                    return;
+                }
                 data.resize(size);
-                if (!istream.eof()) istream.read((char *)data.data(), size);
+                istream.read((char *)data.data(), size);
             }
         };
 
@@ -524,7 +536,7 @@ namespace aplib {
 
             inline void open(const std::string &filename)
             {
-                ostream.open(filename);
+                ostream.open(filename, std::ios::binary);
             }
 
             inline bool fail() { return ostream.fail(); }
@@ -585,25 +597,23 @@ namespace aplib {
             return bytes;
         }
 
-        // Convert byte vector to type
+        // Convert byte vector to type (zeroed if the sizes don't match)
         template <typename T>
         inline T to_data(const std::vector<std::byte> &bytes)
-            requires(sizeof(T) == bytes.size())
         {
             T data = {};
             const size_t t_size = sizeof(T);
-            std::memcpy(&data, bytes.data(), t_size);
+            if (bytes.size() == t_size) std::memcpy(&data, bytes.data(), t_size);
             return data;
         }
 
-        // Convert byte vector to some type vector
+        // Convert byte vector to some type vector (leftover bytes that don't make a whole T are dropped)
         template <typename T>
         inline std::vector<T> to_vector(const std::vector<std::byte> &bytes)
-            requires(bytes.size() % sizeof(T) == 0)
         {
             const size_t t_size = sizeof(T);
             std::vector<T> vector = std::vector<T>(bytes.size() / t_size);
-            std::memcpy(vector.data(), bytes.data(), bytes.size());
+            if (!vector.empty()) std::memcpy(vector.data(), bytes.data(), vector.size() * t_size);
             return vector;
         }
     } // namespace rawfile
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+# Runs every bench/ workload a few times against one lastsmall binary and prints what it found as JSON
+# Usage: bench.py binary [--runs N] [--baseline file] [--update-baseline] [--threshold fraction]
+# Only the standard library, so "make bench" works anywhere there is a python3 (and it builds bench/peak first)
+
+import argparse
+import json
+import os
+import random
+import struct
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(HERE)
+OUT = os.path.join(HERE, "out")
+PEAK = os.path.join(HERE, "peak")
+
+LABEL_FUNCTIONS = 3000
+LABEL_PASSES = 20
+FUNCTIONS = 30000
+PIPELINE_RECORDS = 200000
+
+
+# Thousands of labels and variables: a chain of gotos, each one calling its own function, gone through a few times
+def generate_labels(path):
+    lines = ["# Thousands of labels and variables, made by bench.py", "int one = 1", "int passes = %d" % LABEL_PASSES, "int v0 = 0"]
+    lines += ["int v%d" % k for k in range(1, LABEL_FUNCTIONS + 1)]
+    lines += ["", "pass:", "    goto g0"]
+    for k in range(LABEL_FUNCTIONS):
+        lines += ["g%d:" % k, "    call f%d v%d -> v%d" % (k, k, k + 1), "    goto %s" % ("g%d" % (k + 1) if k + 1 < LABEL_FUNCTIONS else "passed")]
+    lines += ["passed:", "    passes = passes - one", "    branch passes pass", "", "string nl = \"\\n\"", "print v%d" % LABEL_FUNCTIONS, "print nl", "exit", ""]
+    for k in range(LABEL_FUNCTIONS):
+        lines += ["f%d: x" % k, "    local int y", "    y = x + one", "    return y"]
+    with open(path, "w") as file:
+        file.write("\n".join(lines) + "\n")
+
+
+# A big script that runs once, each function called a single time, so loading and optimizing it is most of the time
+def generate_functions(path):
+    lines = ["# A big script run once, made by bench.py", "int one = 1", "int v0 = 0"]
+    lines += ["int v%d" % k for k in range(1, FUNCTIONS + 1)]
+    lines += ["call f%d v%d -> v%d" % (k, k, k + 1) for k in range(FUNCTIONS)]
+    lines += ["string nl = \"\\n\"", "print v%d" % FUNCTIONS, "print nl", "exit", ""]
+    for k in range(FUNCTIONS):
+        lines += ["f%d: x" % k, "    local int y", "    y = x + one", "    return y"]
+    with open(path, "w") as file:
+        file.write("\n".join(lines) + "\n")
+
+
+# What pipeline.lsm reads, the same numbers every time
+def generate_pipeline_input(path):
+    numbers = random.Random(2024)
+    with open(path, "w") as file:
+        file.write("%d\n" % PIPELINE_RECORDS)
+        for _ in range(PIPELINE_RECORDS):
+            file.write("%d %.3f\n" % (numbers.randint(-100000, 100000), numbers.uniform(-1000, 1000)))
+
+
+# Name, script, what goes into stdin (None for nothing)
+def workloads():
+    os.makedirs(OUT, exist_ok=True)
+    labels = os.path.join(OUT, "labels.lsm")
+    functions = os.path.join(OUT, "functions.lsm")
+    pipeline_input = os.path.join(OUT, "pipeline.in")
+    generate_labels(labels)
+    generate_functions(functions)
+    generate_pipeline_input(pipeline_input)
+    return [
+        ("count", os.path.join(HERE, "count.lsm"), None),
+        ("calls", os.path.join(HERE, "calls.lsm"), None),
+        ("strings", os.path.join(HERE, "strings.lsm"), None),
+        ("pipeline", os.path.join(HERE, "pipeline.lsm"), pipeline_input),
+        ("labels", labels, None),
+        ("functions", functions, None),
+    ]
+
+
+# Instructions a run goes through, counted from one --trace of it (header, file table, then chunks of 24 byte records)
+def count_instructions(binary, script, stdin):
+    trace = os.path.join(OUT, "count.trace")
+    if os.path.exists(trace):
+        os.remove(trace)
+    run_once(binary, script, stdin, ["--trace", trace])
+    # Only the chunk headers are read, a whole trace in memory would show up in every later child's peak RSS
+    instructions = 0
+    with open(trace, "rb") as file:
+        magic, version, record_size, files = struct.unpack("<8sIII", file.read(struct.calcsize("<8sIII")))
+        if magic != b"LSMTRACE":
+            raise RuntimeError("%s didn't write a trace" % binary)
+        for _ in range(files):
+            (length,) = struct.unpack("<I", file.read(4))
+            file.seek(length, os.SEEK_CUR)
+        while True:
+            chunk = file.read(8)
+            if len(chunk) < 8:
+                break
+            _, count = struct.unpack("<II", chunk)
+            instructions += count
+            file.seek(count * record_size, os.SEEK_CUR)
+    os.remove(trace)
+    return instructions
+
+
+# One run of command through bench/peak: wall seconds and peak RSS in KB, output thrown away
+# A child of this script would start out with its RSS as the peak (fork copies it), a child of bench/peak with almost nothing
+def measure(command, stdin=None):
+    if not os.path.exists(PEAK):
+        raise RuntimeError("%s isn't built, make bench builds it" % PEAK)
+    source = open(stdin, "rb") if stdin else subprocess.DEVNULL
+    try:
+        output = subprocess.run([PEAK] + command, cwd=ROOT, stdin=source, stdout=subprocess.PIPE, check=True).stdout
+    finally:
+        if stdin:
+            source.close()
+    code, peak, wall = (int(field) for field in output.split())
+    if code != 0:
+        raise RuntimeError("%s exited with %d" % (" ".join(command), code))
+    return wall / 1e9, peak
+
+
+def run_once(binary, script, stdin, extra=()):
+    return measure([binary, "--batch", "--no-cache"] + list(extra) + [os.path.relpath(script, ROOT)], stdin)
+
+
+def median(values):
+    values = sorted(values)
+    middle = len(values) // 2
+    return values[middle] if len(values) % 2 else (values[middle - 1] + values[middle]) / 2
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark lastsmall on the bench/ workloads")
+    parser.add_argument("binary")
+    parser.add_argument("--runs", type=int, default=5)
+    parser.add_argument("--baseline", default=os.path.join(HERE, "baseline.json"))
+    parser.add_argument("--update-baseline", action="store_true", help="Write these results as the new baseline")
+    parser.add_argument("--threshold", type=float, default=0.10, help="How much slower or bigger than the baseline counts as a regression")
+    arguments = parser.parse_args()
+    binary = os.path.abspath(arguments.binary)
+
+    baseline = {}
+    if os.path.exists(arguments.baseline) and not arguments.update_baseline:
+        with open(arguments.baseline) as file:
+            baseline = json.load(file).get("workloads", {})
+
+    # What running nothing at all measures, anything at or below it says nothing about the workload and is left out
+    _, floor = measure(["true"])
+
+    results = {}
+    regressions = []
+    for name, script, stdin in workloads():
+        instructions = count_instructions(binary, script, stdin)
+        run_once(binary, script, stdin)  # Warm up the page cache
+        walls, peaks = [], []
+        for _ in range(arguments.runs):
+            wall, peak = run_once(binary, script, stdin)
+            walls.append(wall)
+            peaks.append(peak)
+        wall = median(walls)
+        result = {
+            "instructions": instructions,
+            "wall_s": round(wall, 6),
+            "wall_min_s": round(min(walls), 6),
+            "wall_max_s": round(max(walls), 6),
+            "instructions_per_s": round(instructions / wall) if wall else 0,
+            "peak_rss_kb": max(peaks) if max(peaks) > floor else None,  # None for unmeasured
+        }
+        if name in baseline:
+            before = baseline[name]["wall_s"]
+            change = wall / before - 1 if before else 0.0
+            result["baseline_wall_s"] = before
+            result["change"] = round(change, 4)
+            result["regression"] = change > arguments.threshold
+            # Memory counts too, when both runs actually measured some
+            rss_before = baseline[name].get("peak_rss_kb")
+            if rss_before and result["peak_rss_kb"]:
+                result["baseline_peak_rss_kb"] = rss_before
+                result["rss_change"] = round(result["peak_rss_kb"] / rss_before - 1, 4)
+                result["regression"] = result["regression"] or result["rss_change"] > arguments.threshold
+            if result["regression"]:
+                regressions.append(name)
+        results[name] = result
+        rss = "%8d KB" % result["peak_rss_kb"] if result["peak_rss_kb"] else "       ? KB"
+        versus = " (%+.1f%% time, %s memory vs baseline)" % (100 * result["change"], "%+.1f%%" % (100 * result["rss_change"]) if "rss_change" in result else "?") if "change" in result else ""
+        print("%-10s %10.4f s %14d instructions/s %s%s" % (name, wall, result["instructions_per_s"], rss, versus), file=sys.stderr)
+
+    report = {"binary": arguments.binary, "runs": arguments.runs, "rss_floor_kb": floor, "workloads": results, "regressions": regressions}
+    print(json.dumps(report, indent=2))
+    with open(os.path.join(OUT, "results.json"), "w") as file:
+        json.dump(report, file, indent=2)
+    if arguments.update_baseline:
+        with open(arguments.baseline, "w") as file:
+            json.dump({"workloads": {name: {key: result[key] for key in ("instructions", "wall_s", "instructions_per_s", "peak_rss_kb")} for name, result in results.items()}}, file, indent=2)
+            file.write("\n")
+    if regressions:
+        print("Slower or bigger than the baseline: " + ", ".join(regressions), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,222 @@
+// Microbenchmarks for the little pieces lastsmall spends its time in, each one timed on its own
+// make micro builds and runs all of them, names (or parts of names) on the command line pick some
+// --samples N for more or fewer samples, --json for something a script can read
+
+#define LASTSMALL_NO_MAIN
+#include "../lastsmall.cpp"
+
+#include <functional>
+#include <random>
+
+namespace micro {
+    // Keeps the compiler from deciding a result nobody looks at didn't need computing
+    template <typename T>
+    inline void Keep(const T &value)
+    {
+#ifdef __GNUC__
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    struct Benchmark {
+        std::string name;
+        size_t ops; // How many of the thing one call of body does, times are per one of them
+        std::function<void()> body;
+    };
+
+    struct Result {
+        std::string name;
+        size_t samples;
+        size_t batch; // Calls of body per sample
+        double min, p50, p90, p99, max; // Nanoseconds per op
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    inline double Seconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    // Warms up for a while, picks a batch that takes about a millisecond, then times samples batches of it
+    inline Result Measure(const Benchmark &benchmark, size_t samples)
+    {
+        Clock::time_point start = Clock::now();
+        size_t calls = 0;
+        while (calls < 3 || Seconds(Clock::now() - start) < 0.05)
+        {
+            benchmark.body();
+            calls++;
+        }
+        double per_call = Seconds(Clock::now() - start) / calls;
+        size_t batch = std::max<size_t>(1, (size_t)(0.001 / std::max(per_call, 1e-9)));
+
+        std::vector<double> times;
+        times.reserve(samples);
+        for (size_t s = 0; s < samples; s++)
+        {
+            Clock::time_point begin = Clock::now();
+            for (size_t b = 0; b < batch; b++) benchmark.body();
+            times.push_back(Seconds(Clock::now() - begin) * 1e9 / (double)(batch * benchmark.ops));
+        }
+        std::sort(times.begin(), times.end());
+        auto Percentile = [&](double p) { return times[std::min(times.size() - 1, (size_t)(p * (double)times.size()))]; };
+        return { benchmark.name, samples, batch, times.front(), Percentile(0.5), Percentile(0.9), Percentile(0.99), times.back() };
+    }
+
+    // Names that look like what a script would have, v0 v1 ... with a bit of variety
+    inline std::vector<std::string> Names(size_t count, const char *prefix)
+    {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t k = 0; k < count; k++) names.push_back(prefix + std::to_string(k) + (k % 3 ? "_value" : ""));
+        return names;
+    }
+
+    // The same names in an order that isn't the one they went in
+    inline std::vector<std::string> Shuffled(std::vector<std::string> names)
+    {
+        std::mt19937 random(42);
+        std::shuffle(names.begin(), names.end(), random);
+        return names;
+    }
+
+    inline std::vector<Benchmark> Benchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+
+        // Lines like the ones in example.lsm and bench/, comments, strings and all
+        static const std::vector<std::string> lines = {
+            "start:",
+            "    int a",
+            "    string prompt = \"Enter a value: \"",
+            "    int add_parameter_1 = a # Or can evaluate only a single variable",
+            "    add_return_value = add_parameter_1 + add_parameter_2",
+            "    exists add_return_value add_return_value_exists",
+            "    call fib a -> x",
+            "    string statement_4 = \"\\n\"",
+            "    # Use exit to end the program, or it will fall through the add:",
+            "    local int z",
+            "fib: k",
+            "    branch big recurse",
+            "    float scale = 0.5",
+            "    string long_one = \"a line that goes on for quite a while so the wide path has something to chew on\"",
+        };
+        benchmarks.push_back({ "tokenizer/split", lines.size(), [] {
+                                  static Tokenizer tokenizer;
+                                  for (const std::string &line : lines)
+                                  {
+                                      tokenizer.split(line);
+                                      Keep(tokenizer.tokens.size());
+                                  }
+                              } });
+
+        static const std::vector<std::string> ints = { "0", "7", "-42", "12345", "2147483647", "99999999999", "12ab", "-" };
+        benchmarks.push_back({ "literals/ToInt", ints.size(), [] {
+                                  for (const std::string &text : ints)
+                                  {
+                                      bool clean;
+                                      Keep(ToInt(text, &clean));
+                                  }
+                              } });
+
+        static const std::vector<std::string> floats = { "0.5", "3.14159", "1e10", "123456.789", ".25", "1e99", "2.5f", "x" };
+        benchmarks.push_back({ "literals/ToFloat", floats.size(), [] {
+                                  for (const std::string &text : floats)
+                                  {
+                                      bool clean;
+                                      Keep(ToFloat(text, &clean));
+                                  }
+                              } });
+
+        // Finding a name that's already there, which is what almost every lookup is
+        for (size_t size : { 16, 1024, 65536 })
+        {
+            auto symbols = std::make_shared<SymbolTable>();
+            auto names = std::make_shared<std::vector<std::string>>(Names(size, "v"));
+            for (const std::string &name : *names) symbols->intern(name);
+            auto order = std::make_shared<std::vector<std::string>>(Shuffled(*names));
+            order->resize(std::min<size_t>(order->size(), 1024));
+            benchmarks.push_back({ "symbols/intern/" + std::to_string(size), order->size(), [symbols, order] {
+                                      for (const std::string &name : *order) Keep(symbols->intern(name));
+                                  } });
+        }
+
+        // Program::labels, how calls and gotos find where they go while compiling
+        for (size_t size : { 16, 1024, 65536 })
+        {
+            auto program = std::make_shared<Program>();
+            std::vector<std::string> names = Names(size, "label");
+            for (size_t k = 0; k < names.size(); k++) program->labels.emplace(names[k], k);
+            auto order = std::make_shared<std::vector<std::string>>(Shuffled(names));
+            order->resize(std::min<size_t>(order->size(), 1024));
+            benchmarks.push_back({ "labels/find/" + std::to_string(size), order->size(), [program, order] {
+                                      for (const std::string &name : *order) Keep(program->labels.find(name)->second);
+                                  } });
+        }
+
+        static const std::string sentence = "the quick brown fox jumps over the lazy dog and then does it all over again because why not";
+        benchmarks.push_back({ "apstr/split", 1, [] { Keep(apstr::split(sentence, ' ')); } });
+
+        static const std::vector<std::string> words = apstr::split(sentence, ' ');
+        benchmarks.push_back({ "apstr/merge", 1, [] { Keep(apstr::merge(words, ' ')); } });
+
+        static const std::string paragraph = std::string(sentence + " ") * 8;
+        benchmarks.push_back({ "apstr/word_wrap", 1, [] { Keep(apstr::word_wrap(paragraph, 40)); } });
+
+        benchmarks.push_back({ "aplib/string*1000", 1, [] { Keep(std::string("ab") * 1000); } });
+
+        static const std::vector<int> numbers(4096, 7);
+        benchmarks.push_back({ "rawfile/to_bytes", 1, [] { Keep(rawfile::to_bytes(numbers)); } });
+
+        static const std::vector<std::byte> bytes = rawfile::to_bytes(numbers);
+        benchmarks.push_back({ "rawfile/to_vector", 1, [] { Keep(rawfile::to_vector<int>(bytes)); } });
+
+        return benchmarks;
+    }
+} // namespace micro
+
+int main(int argc, char **argv)
+{
+    size_t samples = 50;
+    bool json = false;
+    std::vector<std::string> filters;
+    for (int a = 1; a < argc; a++)
+    {
+        std::string argument = argv[a];
+        if (argument == "--json") json = true;
+        else if (argument == "--samples" && a + 1 < argc) samples = std::max(1, std::atoi(argv[++a]));
+        else filters.push_back(argument);
+    }
+
+    std::vector<micro::Result> results;
+    for (const micro::Benchmark &benchmark : micro::Benchmarks())
+    {
+        bool wanted = filters.empty();
+        for (const std::string &filter : filters) wanted = wanted || benchmark.name.find(filter) != std::string::npos;
+        if (!wanted) continue;
+        micro::Result result = micro::Measure(benchmark, samples);
+        results.push_back(result);
+        if (!json)
+        {
+            std::cout << std::left << std::setw(24) << result.name << std::right << std::fixed << std::setprecision(1);
+            std::cout << "  min " << std::setw(9) << result.min << "  p50 " << std::setw(9) << result.p50 << "  p90 " << std::setw(9) << result.p90;
+            std::cout << "  p99 " << std::setw(9) << result.p99 << "  ns/op\n";
+        }
+    }
+
+    if (json)
+    {
+        std::cout << "{\"samples\":" << samples << ",\"results\":[";
+        for (size_t r = 0; r < results.size(); r++)
+        {
+            const micro::Result &result = results[r];
+            std::cout << (r ? "," : "") << "{\"name\":\"" << result.name << "\",\"batch\":" << result.batch << ",\"min_ns\":" << result.min << ",\"p50_ns\":" << result.p50;
+            std::cout << ",\"p90_ns\":" << result.p90 << ",\"p99_ns\":" << result.p99 << ",\"max_ns\":" << result.max << "}";
+        }
+        std::cout << "]}\n";
+    }
+}
@@ -0,0 +1,58 @@
+// Runs one command and says how it went: exit code, peak RSS in KB, wall nanoseconds, on one line of stdout
+// bench.py runs every workload through this, because a child of python starts out with python's RSS as its peak
+// and ru_maxrss never goes below that. A child of this is a copy of something tiny instead
+// Usage: peak command [arguments...], the command's stdout and stderr go to /dev/null, stdin is passed on
+
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s command [arguments...]\n", argv[0]);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t child = fork();
+    if (child < 0)
+    {
+        std::perror("fork");
+        return 2;
+    }
+    if (child == 0)
+    {
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0)
+        {
+            dup2(null, STDOUT_FILENO);
+            dup2(null, STDERR_FILENO);
+            close(null);
+        }
+        execvp(argv[1], argv + 1);
+        _exit(127);
+    }
+
+    int status = 0;
+    rusage usage = {};
+    if (wait4(child, &status, 0, &usage) < 0)
+    {
+        std::perror("wait4");
+        return 2;
+    }
+    auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+#ifdef __APPLE__
+    long peak = usage.ru_maxrss / 1024; // Bytes there, KB on Linux
+#else
+    long peak = usage.ru_maxrss;
+#endif
+    std::printf("%d %ld %lld\n", code, peak, (long long)wall);
+    return 0;
+}
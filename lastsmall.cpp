@@ -3,25 +3,66 @@
 
 // C includes
 #ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <termios.h>
 #include <unistd.h>
 #else
+#include <io.h>
 typedef unsigned int tcflag_t;
 struct termios {};
 #define ECHO 1
 #endif
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Cheapest clock there is for --trace
+#ifndef TRACE_RDTSC
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRACE_RDTSC true
+#else
+#define TRACE_RDTSC false
+#endif
+#endif
+
+#if TRACE_RDTSC
+#include <x86intrin.h>
+#endif
+
 // C++ includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
 #include <chrono>
 #include <cmath>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <exception>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 using namespace aplib;
@@ -83,969 +124,5521 @@ void restore_tty_flag()
 #endif
 }
 
-// "Templates cannot be declared inside of a local class -- clang"
-class Debugger {
+// Whole file as one read-only view, mapped straight from the page cache instead of copied line by line
+// Windows gets it read into a string, same view either way
+class MappedFile {
+    const char *data = nullptr;
+    size_t size = 0;
+    bool failed = true;
+#ifdef _WIN32
+    std::string contents;
+#endif
+
 public:
-    bool yes;
-    template <typename T>
-    Debugger &operator<<(const T &data)
+    MappedFile() = default;
+    explicit MappedFile(const std::string &filename)
     {
-        if (yes)
+#ifndef _WIN32
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info = {};
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
         {
-            std::cout << data;
+            failed = false;
+            size = (size_t)info.st_size;
+            if (size)
+            {
+                void *memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (memory == MAP_FAILED)
+                {
+                    failed = true;
+                    size = 0;
+                }
+                else
+                {
+                    data = (const char *)memory;
+                    madvise(memory, size, MADV_SEQUENTIAL); // Read front to back exactly once
+                }
+            }
         }
-        return *this;
-    }
-};
-
-#ifdef DEBUG
-#ifndef RANDOM_CRASH
-#define RANDOM_CRASH false
-#endif
-#ifndef FRUSTRATION_MULTIPLIER
-#define FRUSTRATION_MULTIPLIER 0.1
-#endif
-#ifndef YES_THING
-#define YES_THING true
-#endif
+        ::close(fd);
 #else
-#ifndef RANDOM_CRASH
-#define RANDOM_CRASH true
-#endif
-#ifndef FRUSTRATION_MULTIPLIER
-#define FRUSTRATION_MULTIPLIER 1
-#endif
-#ifndef YES_THING
-#define YES_THING false
+        std::ifstream ifile(filename, std::ios::binary);
+        if (ifile.fail()) return;
+        contents.assign(std::istreambuf_iterator<char>(ifile), std::istreambuf_iterator<char>());
+        data = contents.data();
+        size = contents.size();
+        failed = false;
 #endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (data) munmap((void *)data, size);
 #endif
+    }
 
-int main(int argc, char **argv)
+    bool fail() const { return failed; }
+    std::string_view text() const { return std::string_view(data, size); } // Empty (and null) when there is nothing
+};
+
+// Where each line starts and ends, like std::getline would have split them (no empty line after the last newline)
+inline std::vector<std::string_view> split_lines(std::string_view text)
 {
-    // --------------------------------
-    // Flags setup
-    // --------------------------------
+    std::vector<std::string_view> lines;
+    lines.reserve(text.size() / 32 + 1);
+    const char *start = text.data();
+    const char *end = start + text.size();
+    while (start < end)
+    {
+        const char *newline = (const char *)std::memchr(start, '\n', end - start);
+        if (!newline) newline = end;
+        lines.emplace_back(start, newline - start);
+        start = newline + 1;
+    }
+    return lines;
+}
 
-    enum class Flags {
-        help = 0,
-        debug
-    };
-    std::vector<argp::Flag> flags = {
-        argp::Flag { "Print this help message", { "help", "manual", "man" }, { 'h', 'm', '?' }, {}, 0 },
-        argp::Flag { "Show each line ran", { "debug" }, { 'd' }, {}, 0 }
-    };
+// stdout through one big buffer: every std::cout write lands here too, so nothing comes out of order
+// Flushed when it fills up, when someone flushes, and at exit, plus after every newline when a human is watching on a TTY
+class OutputBuffer : public std::streambuf {
+    char buffer[1 << 16];
+    bool line_buffered = true;
+    std::streambuf *original = nullptr; // What std::cout had before, put back on the way out so its own final flush doesn't land here
 
-    // --------------------------------
-    // Program variables
-    // --------------------------------
+public:
+    OutputBuffer()
+    {
+        setp(buffer, buffer + sizeof(buffer));
+#ifndef _WIN32
+        line_buffered = isatty(STDOUT_FILENO);
+#endif
+    }
 
-    std::vector<std::string> filenames;
-    int debug = false;
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
 
-    // --------------------------------
-    // Command line flag handlers
-    // --------------------------------
+    // stdout was swapped for something else (a --jobs worker's temp file), buffer however that deserves
+    void reopened()
+    {
+#ifndef _WIN32
+        line_buffered = isatty(STDOUT_FILENO);
+#endif
+    }
 
-    auto Help = [&](const argp::Option &option) {
-        (void)option;
-        argp::print_help(flags, "Usage: Just use the program already... pass in the filename ok?\n       lastsmall filename.ls\nYou have some options tho:\n", "\nNo you don't report any bugs because I will never resolve them.\n");
-        std::exit(0);
-    };
+    ~OutputBuffer()
+    {
+        sync();
+        if (original) std::cout.rdbuf(original);
+    }
 
-    auto Debug = [&](const argp::Option &option) {
-        (void)option;
-        debug = !debug;
-    };
+    // Takes over std::cout, C stdio and iostreams stop keeping each other in sync since only this writes to stdout
+    void install()
+    {
+        std::ios::sync_with_stdio(false);
+        original = std::cout.rdbuf(this);
+    }
 
-    // --------------------------------
-    // Command line parsing
-    // --------------------------------
+    void put(std::string_view text)
+    {
+        xsputn(text.data(), (std::streamsize)text.size());
+    }
 
-#ifndef DEBUG
-    // Remove 5 seconds from their life expectancy every time they use this program
-    std::string creepy_message = "You have to wait 5 seconds for the below pointless progress bar to finish counting";
-    std::cout << red << creepy_message << reset << '\n';
-#endif
+    void put(char c)
+    {
+        if (pptr() == epptr()) sync();
+        *pptr() = c;
+        pbump(1);
+        if (line_buffered && c == '\n') sync();
+    }
 
-    auto Pause = [](int milliseconds) {
-        std::this_thread::sleep_for((std::chrono::milliseconds)(int)(milliseconds * FRUSTRATION_MULTIPLIER));
-    };
+    // Numbers are written straight into the buffer, the same way std::cout would have formatted them
+    void put(int value)
+    {
+        if (epptr() - pptr() < 16) sync();
+        pbump((int)(std::to_chars(pptr(), epptr(), value).ptr - pptr()));
+    }
 
-    auto ProgressCity = [Pause](float width, float time) {
-        std::cout << hide_cursor;
-        remove_tty_flag(ECHO);
-        for (float i = 0; i <= 100.0f; i++)
+    void put(float value)
+    {
+        if (epptr() - pptr() < 32) sync();
+        pbump((int)(std::to_chars(pptr(), epptr(), value, std::chars_format::general, 6).ptr - pptr()));
+    }
+
+protected:
+    int sync() override
+    {
+        size_t size = pptr() - pbase();
+        setp(buffer, buffer + sizeof(buffer));
+        return Write(buffer, size) ? 0 : -1;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (sync() != 0) return traits_type::eof();
+        if (!traits_type::eq_int_type(c, traits_type::eof())) put(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char *data, std::streamsize size) override
+    {
+        if (size > epptr() - pptr())
         {
-            std::cout << "[";
-            for (float j = 0; j < width; j++)
-            {
-                if (j < i / (100.0f / width)) std::cout << "#";
-                else std::cout << " ";
-            }
-            std::cout << "] " << i << "%\r" << std::flush;
-            Pause((int)time * 10);
+            sync();
+            // Bigger than the whole buffer goes straight out
+            if (size >= (std::streamsize)sizeof(buffer)) return Write(data, size) ? size : 0;
         }
-        insert_tty_flag(ECHO);
-        std::cout << show_cursor << '\n';
-    };
-
-#ifndef DEBUG
-    ProgressCity(creepy_message.size() - 7.0f, 5.0f);
-#endif
+        std::memcpy(pptr(), data, size);
+        pbump((int)size);
+        if (line_buffered && std::memchr(data, '\n', size)) sync();
+        return size;
+    }
 
-    std::vector<argp::Option> options = argp::get_options_from_flags(argc, argv, flags);
-    for (const argp::Option &option : options)
+private:
+    static bool Write(const char *data, size_t size)
     {
-        if (!option.unrecognized_option.empty())
+#ifndef _WIN32
+        while (size)
         {
-            if (option.unrecognized_option.substr(0, 2) == "--" || option.unrecognized_option.substr(0, 1) == "-" || option.unrecognized_option.substr(0, 1) == "/")
-            {
-                std::cout << "Idk what the heck are you talking about... What do you mean by " << red << option.unrecognized_option << reset << "??\n";
-            }
-            else
-            {
-                filenames.push_back(option.unrecognized_option);
-            }
+            ssize_t written = ::write(STDOUT_FILENO, data, size);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            data += written;
+            size -= written;
         }
-        if (option.flag == &flags[(int)Flags::help]) Help(option);
-        if (option.flag == &flags[(int)Flags::debug]) Debug(option);
+        return true;
+#else
+        bool ok = std::fwrite(data, 1, size, stdout) == size;
+        return std::fflush(stdout) == 0 && ok;
+#endif
     }
+};
 
-    // --------------------------------
-    // Time wasting
-    // --------------------------------
+// Installed at the start of main, a global so std::exit still flushes it
+static OutputBuffer output;
 
-    std::srand(std::time(0));
-    if (RANDOM_CRASH && std::rand() % 10 == 0)
+// stdin pulled in big read()s and parsed right out of the buffer, for scan
+// Same results as the std::cin >> and std::getline it replaces, down to a failed read making every later one fail too
+class InputReader {
+    char buffer[1 << 16];
+    size_t position = 0;
+    size_t size = 0;
+    bool ended = false;  // Nothing more to read
+    bool failed = false; // Like std::cin's failbit, sticks forever
+    std::string number;  // Float being read, kept around so it doesn't allocate every time
+
+    // Whatever is buffered, after refilling if it ran out, -1 at the end
+    int Peek()
     {
-        std::cout << red << "You're too unlucky! The pointless timer just randomly failed!! " << reset << "This happens 1/10th of the times. Quitting please don't stop me I shall end my life (process) right now\n";
-        std::cout << "Quitting...\n";
-        ProgressCity(11 - 7.0f, 5.0f);
-        return 0;
+        if (position == size && !Refill()) return -1;
+        return (unsigned char)buffer[position];
     }
 
-    // Yeah we remind user if they forgot something, after they have ruined 5 seconds of their life
-    if (filenames.empty())
+    bool Refill()
     {
-        std::cout << red << "You literally forgot the main thing... really??\n";
+        if (ended) return false;
+        output.pubsync(); // Like std::cin being tied to std::cout, the prompt shows up before we wait
+#ifndef _WIN32
+        ssize_t got;
+        do got = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+        while (got < 0 && errno == EINTR);
+#else
+        long long got = (long long)std::fread(buffer, 1, sizeof(buffer), stdin);
+#endif
+        position = 0;
+        size = got > 0 ? (size_t)got : 0;
+        ended = size == 0;
+        return !ended;
     }
 
-    // --------------------------------
-    // Program stuff
-    // --------------------------------
+    static bool Space(char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
 
-    auto tokenize = [](const std::string &line) -> std::vector<std::string> {
-        std::vector<std::string> result;
-        auto Id = [](char c) -> bool {
-            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == '_') || (c >= '0' && c <= '9') || (c == '.');
-        };
-        if (line.empty()) return result;
-        bool is_id = Id(line[0]);
-        std::string temp;
-        for (size_t i = 0; i < line.size(); i++)
+    static bool Digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // What >> does before anything, false if there is nothing left to read
+    bool SkipSpace()
+    {
+        if (failed) return false;
+        for (;;)
         {
-            char c = line[i];
-            if (c == '\"')
-            {
-                while (line[++i] != '\"')
-                {
-                    if (line[i] == '\\')
-                    {
-                        i++;
-                        if (line[i] == 'n')
-                            temp += '\n';
-                        else if (line[i] == 't')
-                            temp += '\t';
-                        else
-                            temp += line[i];
-                        continue;
-                    }
-                    temp += line[i];
-                }
-                result.push_back(temp);
-                temp = "";
-                continue;
-            }
-            if (c == '\\')
-            {
-                i++;
-                if (line[i] == 'n')
-                    temp += '\n';
-                else if (line[i] == 't')
-                    temp += '\t';
-                else
-                    temp += line[i];
-                continue;
-            }
-            if (c == '#')
-            {
-                break;
-            }
-            if (c == ' ' || c == '\n' || c == '\t')
+            while (position < size && Space(buffer[position])) position++;
+            if (position < size) return true;
+            if (!Refill())
             {
-                if (!temp.empty())
-                {
-                    result.push_back(temp);
-                    temp = "";
-                }
-                continue;
-            }
-            bool id = Id(c);
-            if (is_id == id)
-            {
-                // Remove the check and else part to allow operators with multiple symbols
-                if (id) temp.push_back(c);
-                else
-                {
-                    if (!temp.empty()) result.push_back(temp);
-                    temp = c;
-                }
+                failed = true;
+                return false;
             }
-            else
+        }
+    }
+
+    // Takes the character if it is one of these
+    bool Accept(std::string_view these, std::string &into)
+    {
+        int c = Peek();
+        if (c == -1 || these.find((char)c) == std::string_view::npos) return false;
+        into += (char)c;
+        position++;
+        return true;
+    }
+
+    // Takes every digit in a row, a buffer at a time
+    bool AcceptDigits(std::string &into)
+    {
+        bool any = false;
+        for (;;)
+        {
+            size_t start = position;
+            while (position < size && Digit(buffer[position])) position++;
+            into.append(buffer + start, position - start);
+            any = any || position > start;
+            if (position < size || !Refill()) return any;
+        }
+    }
+
+public:
+    bool read(int &value)
+    {
+        value = 0;
+        if (!SkipSpace()) return false;
+        bool negative = false;
+        if (Peek() == '-' || Peek() == '+') negative = buffer[position++] == '-';
+        long long magnitude = 0;
+        bool digits = false, overflow = false;
+        for (;;)
+        {
+            for (; position < size && Digit(buffer[position]); position++)
             {
-                is_id = id;
-                if (!temp.empty()) result.push_back(temp);
-                temp = c;
+                digits = true;
+                if (magnitude <= (long long)std::numeric_limits<int>::max() + 1) magnitude = magnitude * 10 + (buffer[position] - '0');
             }
+            if (position < size || !Refill()) break;
         }
-        if (!temp.empty())
+        overflow = magnitude > (negative ? (long long)std::numeric_limits<int>::max() + 1 : (long long)std::numeric_limits<int>::max());
+        if (!digits || overflow)
         {
-            result.push_back(temp);
+            failed = true;
+            if (overflow) value = negative ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+            return false;
         }
-        return result;
-    };
-
-    auto ToInt = [](const std::string &string) -> int {
-        std::stringstream ss = std::stringstream(string);
-        int value;
-        ss >> value;
-        return value;
-    };
-
-    auto ToFloat = [](const std::string &string) -> float {
-        std::stringstream ss = std::stringstream(string);
-        float value;
-        ss >> value;
-        return value;
-    };
-
-    auto ToChar = [](const std::string &string) -> char {
-        return string[0];
-    };
-
-    // --------------------------------
-    // Actual program stuff
-    // --------------------------------
-
-    struct Variable {
-        enum Type {
-            _int,
-            _float,
-            _char,
-            _string
-        };
-        std::string name;
-        Type type;
-        int value_int = 0;
-        float value_float = 0.0f;
-        char value_char = ' ';
-        std::string value_string = "";
-    };
-
-    std::vector<Variable> variables;
-
-    struct Jump {
-        std::string name;
-        size_t line_number;
-    };
-
-    std::vector<Jump> goneto_stack;
+        value = (int)(negative ? -magnitude : magnitude);
+        return true;
+    }
 
-    for (const std::string &filename : filenames)
+    bool read(float &value)
     {
-        std::ifstream ifile = std::ifstream(filename);
-        if (ifile.fail())
+        value = 0;
+        if (!SkipSpace()) return false;
+        // Sign, digits with at most one point, then an exponent only if there was a digit
+        number.clear();
+        Accept("+-", number);
+        bool mantissa = AcceptDigits(number);
+        if (Accept(".", number)) mantissa = AcceptDigits(number) || mantissa;
+        if (mantissa && Accept("eE", number))
         {
-            std::cout << "You idiot. You didn't realize that " << red << filename << reset << " does not exist... bruh moment\n";
+            Accept("+-", number);
+            AcceptDigits(number);
         }
-        std::string file_line;
-        std::vector<std::string> lines;
-        while (std::getline(ifile, file_line))
+        // All of it has to be a number, "1e" or "." is a failed read that still ate what it saw
+        const char *first = number.data() + (!number.empty() && (number[0] == '+' || number[0] == '-'));
+        const char *last = number.data() + number.size();
+        auto [end, error] = std::from_chars(first, last, value);
+        if (error == std::errc::result_out_of_range)
         {
-            lines.push_back(file_line);
+            value = std::strtof(first, nullptr); // Too small ends up 0 or denormal like the stream had it, too big is inf and handled below
+            end = last;
+            error = std::errc();
         }
-        for (size_t i = 0; i < lines.size(); i++)
+        if (error != std::errc() || end != last || first == last)
+        {
+            value = 0;
+            failed = true;
+            return false;
+        }
+        if (number[0] == '-') value = -value;
+        if (std::isinf(value))
+        {
+            value = value > 0 ? std::numeric_limits<float>::max() : -std::numeric_limits<float>::max();
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool read(char &value)
+    {
+        if (!SkipSpace()) return false;
+        value = buffer[position++];
+        return true;
+    }
+
+    // Up to the newline (which is eaten), no skipping anything first
+    bool read_line(std::string &line)
+    {
+        line.clear();
+        if (failed) return false;
+        for (;;)
         {
-            const std::string &line = lines[i];
-            if (debug)
+            if (Peek() == -1)
             {
-                std::cout << green << filename << reset << ": # " << std::setw((int)std::log10(lines.size()) + 1) << green << i + 1 << reset << " : " << line << std::endl;
+                if (line.empty()) failed = true;
+                return !line.empty();
             }
-            std::vector<std::string> tokens = tokenize(line);
-            Debugger yesbug;
-            yesbug.yes = YES_THING;
-            for (auto t : tokens) yesbug << "[" << t << "]\n";
-            if (tokens.empty())
+            const char *start = buffer + position;
+            const char *newline = (const char *)std::memchr(start, '\n', size - position);
+            if (newline)
+            {
+                line.append(start, newline - start);
+                position += newline - start + 1;
+                return true;
+            }
+            line.append(start, size - position);
+            position = size;
+        }
+    }
+};
+
+// Only scan reads stdin, and only through this
+static InputReader input;
+
+// Computed goto is a GNU thing, everyone else gets a switch
+#ifndef THREADED_DISPATCH
+#ifdef __GNUC__
+#define THREADED_DISPATCH true
+#else
+#define THREADED_DISPATCH false
+#endif
+#endif
+
+// Records each thread keeps before writing them out, 24 bytes each
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 4096
+#endif
+
+#ifdef DEBUG
+#ifndef RANDOM_CRASH
+#define RANDOM_CRASH false
+#endif
+#ifndef FRUSTRATION_MULTIPLIER
+#define FRUSTRATION_MULTIPLIER 0.1
+#endif
+#ifndef YES_THING
+#define YES_THING true
+#endif
+#else
+#ifndef RANDOM_CRASH
+#define RANDOM_CRASH true
+#endif
+#ifndef FRUSTRATION_MULTIPLIER
+#define FRUSTRATION_MULTIPLIER 1
+#endif
+#ifndef YES_THING
+#define YES_THING false
+#endif
+#endif
+
+// "Templates cannot be declared inside of a local class -- clang"
+// Decided at compile time, so with it off every yesbug line compiles to nothing
+class Debugger {
+public:
+    static constexpr bool yes = YES_THING;
+    template <typename T>
+    Debugger &operator<<(const T &data)
+    {
+        if constexpr (yes)
+        {
+            std::cout << data;
+        }
+        return *this;
+    }
+};
+
+// --------------------------------
+// Variable storage
+// --------------------------------
+
+// One variable slot in 16 bytes, the value shares space with the string and short strings don't even allocate
+class Variable {
+public:
+    enum Type : unsigned char {
+        _int,
+        _float,
+        _char,
+        _string
+    };
+
+    static constexpr uint32_t inline_capacity = 8;
+
+    union {
+        int value_int;
+        float value_float;
+        char value_char;
+        char *string_heap;                   // Strings longer than inline_capacity
+        char string_inline[inline_capacity]; // Strings that fit
+    };
+    uint32_t string_size = 0;
+    Type type = _int;
+    bool live = false;     // Whether the slot holds a variable right now, declaring and deleting flip it
+    bool borrowed = false; // string_heap belongs to a call frame's arena, which frees it all at once
+
+    Variable()
+        : value_int(0) {}
+    explicit Variable(int value)
+        : value_int(value), type(_int), live(true) {}
+    explicit Variable(float value)
+        : value_float(value), type(_float), live(true) {}
+    explicit Variable(char value)
+        : value_char(value), type(_char), live(true) {}
+    explicit Variable(std::string_view value)
+        : value_int(0), live(true)
+    {
+        set_string(value);
+    }
+
+    Variable(const Variable &other)
+        : value_int(0)
+    {
+        *this = other;
+    }
+
+    Variable(Variable &&other) noexcept
+        : value_int(0)
+    {
+        *this = std::move(other);
+    }
+
+    ~Variable()
+    {
+        release();
+    }
+
+    Variable &operator=(const Variable &other)
+    {
+        if (this == &other) return *this;
+        if (other.type == _string)
+        {
+            set_string(other.as_string());
+        }
+        else
+        {
+            release();
+            std::memcpy((void *)this, (const void *)&other, sizeof(Variable));
+        }
+        live = other.live;
+        return *this;
+    }
+
+    Variable &operator=(Variable &&other) noexcept
+    {
+        if (this == &other) return *this;
+        release();
+        std::memcpy((void *)this, (const void *)&other, sizeof(Variable));
+        // The heap string (if any) belongs to us now
+        other.type = _int;
+        other.string_size = 0;
+        other.borrowed = false;
+        return *this;
+    }
+
+    bool holds(Type expected) const
+    {
+        return live && type == expected;
+    }
+
+    // Reading as another type gives what the old separate fields always held for it
+    int as_int() const { return type == _int ? value_int : 0; }
+    float as_float() const { return type == _float ? value_float : 0.0f; }
+    char as_char() const { return type == _char ? value_char : ' '; }
+
+    std::string_view as_string() const
+    {
+        if (type != _string) return "";
+        return std::string_view(string_size > inline_capacity ? string_heap : string_inline, string_size);
+    }
+
+    // Safe even when value points into this variable's own string
+    // memory is where a long string goes instead of the heap (at least value.size() bytes that outlive this variable's use of them)
+    void set_string(std::string_view value, char *memory = nullptr)
+    {
+        char *old_heap = type == _string && string_size > inline_capacity && !borrowed ? string_heap : nullptr;
+        if (value.size() > inline_capacity)
+        {
+            char *data = memory ? memory : new char[value.size()];
+            std::memcpy(data, value.data(), value.size());
+            string_heap = data;
+            borrowed = memory != nullptr;
+        }
+        else
+        {
+            std::memmove(string_inline, value.data(), value.size());
+            borrowed = false;
+        }
+        string_size = (uint32_t)value.size();
+        type = _string;
+        delete[] old_heap;
+    }
+
+private:
+    void release()
+    {
+        if (type == _string && string_size > inline_capacity && !borrowed) delete[] string_heap;
+        type = _int;
+        string_size = 0;
+        borrowed = false;
+    }
+};
+
+static_assert(sizeof(Variable) == 16, "Variable is supposed to stay tiny");
+
+// Every name the program ever mentions gets a slot, decided when the file is compiled
+struct SymbolTable {
+    // Looks up string_views without making a string first
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+    };
+
+    std::unordered_map<std::string, size_t, Hash, std::equal_to<>> slots;
+    std::vector<std::string> names;
+
+    size_t intern(std::string_view name)
+    {
+        auto found = slots.find(name);
+        if (found != slots.end()) return found->second;
+        slots.emplace(std::string(name), names.size());
+        names.emplace_back(name);
+        return names.size() - 1;
+    }
+};
+
+// --------------------------------
+// Tokenizer
+// --------------------------------
+
+// Identifier characters and whitespace get found 64 bytes at a time, everything else (operators, #, ", \) is rare enough to walk one by one
+// SSE2 is always there on x86-64, AVX2 only if the compiler was told it can use it (-mavx2 or -march=native)
+namespace classify {
+    // Bit per byte of one 64 byte block
+    struct Block {
+        uint64_t id;    // a-z A-Z 0-9 _ .
+        uint64_t space; // ' ' '\t' '\n', '\r' is an operator like it always was
+    };
+
+    constexpr bool id(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == '_') || (c >= '0' && c <= '9') || (c == '.');
+    }
+
+    constexpr bool space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n';
+    }
+
+#if defined(__AVX2__)
+    inline Block block(const char *p)
+    {
+        uint64_t id = 0, space = 0;
+        for (int half = 0; half < 2; half++)
+        {
+            __m256i c = _mm256_loadu_si256((const __m256i *)(p + half * 32));
+            __m256i folded = _mm256_or_si256(c, _mm256_set1_epi8(0x20)); // A-Z onto a-z
+            __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+            __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')), _mm256_cmpeq_epi8(c, _mm256_set1_epi8('.')));
+            __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')), _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\t')), _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n'))));
+            id |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter, digit), other)) << (half * 32);
+            space |= (uint64_t)(uint32_t)_mm256_movemask_epi8(blank) << (half * 32);
+        }
+        return { id, space };
+    }
+#elif defined(__SSE2__)
+    inline Block block(const char *p)
+    {
+        uint64_t id = 0, space = 0;
+        for (int quarter = 0; quarter < 4; quarter++)
+        {
+            __m128i c = _mm_loadu_si128((const __m128i *)(p + quarter * 16));
+            __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20)); // A-Z onto a-z
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(folded, _mm_set1_epi8('z' + 1)));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+            __m128i other = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('_')), _mm_cmpeq_epi8(c, _mm_set1_epi8('.')));
+            __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\n'))));
+            id |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), other)) << (quarter * 16);
+            space |= (uint64_t)(uint16_t)_mm_movemask_epi8(blank) << (quarter * 16);
+        }
+        return { id, space };
+    }
+#else
+    inline Block block(const char *p)
+    {
+        uint64_t id = 0, space = 0;
+        for (int k = 0; k < 64; k++)
+        {
+            id |= (uint64_t)classify::id(p[k]) << k;
+            space |= (uint64_t)classify::space(p[k]) << k;
+        }
+        return { id, space };
+    }
+#endif
+} // namespace classify
+
+// Tokens are spans over the line, only the ones with escapes or glued to a string get their own copy in decoded
+// Same rules as always: runs of identifier characters, one token per operator, strings and escapes stick to whatever is before them
+class Tokenizer {
+public:
+    enum class Kind : unsigned char {
+        word,   // Run of identifier characters
+        symbol, // One operator character
+        quoted, // Inside of a "string" that had no escapes
+        decoded // Had escapes or was glued together, lives in decoded
+    };
+
+    struct Token {
+        uint32_t offset; // Into the line, or into decoded for Kind::decoded
+        uint32_t length;
+        Kind kind;
+    };
+
+    std::vector<Token> tokens;
+
+    // Splits a line, the views it gives out last until the next call (and as long as the line does)
+    void split(std::string_view line)
+    {
+        tokens.clear();
+        decoded.clear();
+        this->line = line;
+        if (line.empty()) return;
+        // Never longer than the line, so reserving that keeps earlier tokens' views put
+        if (decoded.capacity() < line.size()) decoded.reserve(line.size());
+        Classify();
+
+        bool is_id = classify::id(line[0]);
+        Pending pending;
+        size_t i = 0;
+        while (i < line.size())
+        {
+            char c = line[i];
+            if (c == '"')
+            {
+                size_t start = ++i;
+                while (i < line.size() && line[i] != '"' && line[i] != '\\') i++;
+                if (pending.length == 0 && (i == line.size() || line[i] == '"'))
+                {
+                    // Nothing to decode, the token is just the inside
+                    tokens.push_back({ (uint32_t)start, (uint32_t)(i - start), Kind::quoted });
+                }
+                else
+                {
+                    Decode(pending);
+                    decoded.append(line.substr(start, i - start));
+                    while (i < line.size() && line[i] != '"')
+                    {
+                        if (line[i] == '\\')
+                        {
+                            if (++i == line.size()) break;
+                            decoded += Escape(line[i]);
+                        }
+                        else decoded += line[i];
+                        i++;
+                    }
+                    tokens.push_back({ pending.offset, (uint32_t)(decoded.size() - pending.offset), Kind::decoded });
+                }
+                pending = {};
+                i++;
+                continue;
+            }
+            if (c == '\\')
             {
+                if (++i == line.size()) break;
+                Decode(pending);
+                decoded += Escape(line[i]);
+                pending.length++;
+                i++;
+                continue;
+            }
+            if (c == '#')
+            {
+                break;
+            }
+            if (classify::space(c))
+            {
+                Flush(pending);
+                i = Skip(space_bits, i);
                 continue;
             }
-            try
-            {
-                auto Diagnose = [&](size_t line, std::string what) {
-                    std::string message = "Line #" + std::to_string(line + 1) + " has witnessed a witch. Diagnosing...";
-                    std::cout << message << '\n';
-                    ProgressCity(message.size() - 7.0f, 2.0f);
-                    std::cout << "Skill issue. ";
-                    std::flush(std::cout);
-                    Pause(2000);
-                    std::cout << what;
-                    std::flush(std::cout);
-                    Pause(2000);
-                    std::cout << "Eh... whatever I guess...\n";
-                    Pause(2000);
-                };
+            if (classify::id(c))
+            {
+                size_t end = Skip(id_bits, i);
+                if (!is_id)
+                {
+                    Flush(pending);
+                    is_id = true;
+                }
+                Append(pending, i, end - i);
+                i = end;
+                continue;
+            }
+            // Remove the Flush to allow operators with multiple symbols
+            is_id = false;
+            Flush(pending);
+            pending = { (uint32_t)i, 1, Kind::symbol };
+            i++;
+        }
+        Flush(pending);
+    }
+
+    std::string_view text(const Token &token) const
+    {
+        return (token.kind == Kind::decoded ? std::string_view(decoded) : line).substr(token.offset, token.length);
+    }
+
+private:
+    struct Pending {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        Kind kind = Kind::word;
+    };
+
+    std::string_view line;
+    std::string decoded;
+    std::vector<uint64_t> id_bits;    // Bit per byte of the line
+    std::vector<uint64_t> space_bits;
+
+    static char Escape(char c)
+    {
+        if (c == 'n') return '\n';
+        if (c == 't') return '\t';
+        return c;
+    }
+
+    void Classify()
+    {
+        size_t blocks = (line.size() + 63) / 64;
+        id_bits.resize(blocks);
+        space_bits.resize(blocks);
+        size_t k = 0;
+        for (; (k + 1) * 64 <= line.size(); k++)
+        {
+            classify::Block block = classify::block(line.data() + k * 64);
+            id_bits[k] = block.id;
+            space_bits[k] = block.space;
+        }
+        // The last few bytes go through a copy so nothing reads past the line (or off the end of the mapping)
+        if (k < blocks)
+        {
+            char tail[64] = {};
+            std::memcpy(tail, line.data() + k * 64, line.size() - k * 64);
+            classify::Block block = classify::block(tail);
+            id_bits[k] = block.id;
+            space_bits[k] = block.space;
+        }
+    }
+
+    // First position at or after from whose bit is clear, the line's end if there isn't one
+    size_t Skip(const std::vector<uint64_t> &bits, size_t from) const
+    {
+        size_t k = from / 64;
+        uint64_t word = ~bits[k] & (~0ull << (from % 64));
+        while (!word)
+        {
+            if (++k == bits.size()) return line.size();
+            word = ~bits[k];
+        }
+        return std::min(k * 64 + std::countr_zero(word), line.size());
+    }
+
+    // Moves what's pending over to decoded so more can be glued on
+    void Decode(Pending &pending)
+    {
+        if (pending.kind == Kind::decoded) return;
+        uint32_t offset = (uint32_t)decoded.size();
+        decoded.append(line.substr(pending.offset, pending.length));
+        pending.offset = offset;
+        pending.kind = Kind::decoded;
+    }
+
+    void Append(Pending &pending, size_t offset, size_t length)
+    {
+        if (pending.length == 0) pending = { (uint32_t)offset, 0, Kind::word };
+        if (pending.kind != Kind::decoded && pending.offset + pending.length != offset) Decode(pending);
+        if (pending.kind == Kind::decoded) decoded.append(line.substr(offset, length));
+        pending.length += (uint32_t)length;
+    }
+
+    void Flush(Pending &pending)
+    {
+        if (pending.length) tokens.push_back({ pending.offset, pending.length, pending.kind });
+        pending = {};
+    }
+};
+
+// --------------------------------
+// Literals
+// --------------------------------
+
+// Reads as much number as the text starts with (0 if none), clean says whether that was all of it
+// Only ever called while compiling, literals are kept in Instruction::constant after that
+inline int ToInt(std::string_view text, bool *clean = nullptr)
+{
+    int value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error == std::errc::result_out_of_range) value = std::numeric_limits<int>::max(); // Like the stringstream this used to be
+    if (clean) *clean = error == std::errc() && end == text.data() + text.size();
+    return value;
+}
+
+inline float ToFloat(std::string_view text, bool *clean = nullptr)
+{
+    float value = 0;
+    // from_chars knows inf and nan, the stringstream never did and names like "inf" are variables anyway
+    bool numeric = !text.empty() && (std::isdigit((unsigned char)text[0]) || text[0] == '.');
+    auto [end, error] = numeric ? std::from_chars(text.data(), text.data() + text.size(), value) : std::from_chars_result { text.data(), std::errc::invalid_argument };
+    if (error == std::errc::result_out_of_range) value = std::numeric_limits<float>::infinity();
+    if (clean) *clean = error == std::errc() && end == text.data() + text.size();
+    return value;
+}
+
+inline char ToChar(std::string_view text)
+{
+    return text.empty() ? '\0' : text[0];
+}
+
+// --------------------------------
+// Keywords
+// --------------------------------
+
+// What a line does, figured out once when the file is loaded instead of every time it runs
+// Operands are variable slots, text is the label name or what the initializer/jmp line said
+enum class Opcode : unsigned char {
+    label,          // text = label, arguments = parameters
+    declare_int,    // name [initializer], text = initializer
+    declare_float,  // name [initializer], text = initializer
+    declare_char,   // name [initializer], text = initializer
+    declare_string, // name [initializer], text = initializer
+    call,           // [result], text = label, arguments = what it passes
+    go_to,          // text = label
+    jmp,            // text = line
+    go_back,        // [value]
+    scan,           // name
+    print,          // name
+    obliterate,     // name
+    branch,         // name, text = label
+    exists,         // name, text = label
+    make_local,     // name (always right before its declaration)
+    escape,         //
+    assign_copy,    // name source
+    assign_not,     // name source
+    assign_binary,  // name left right (operation says which one)
+    assign_nothing, // name (valid assignment that does nothing, like "a = b c")
+    assign_wdym,    // name (no "=" after the name)
+    add_int,        // name left right, all proven to be ints (assign_binary with the type already picked)
+    sub_int,        // name left right, all proven to be ints
+    mul_int,        // name left right, all proven to be ints
+    div_int,        // name left right, all proven to be ints
+    mod_int,        // name left right, all proven to be ints
+    add_float,      // name left right, all proven to be floats
+    sub_float,      // name left right, all proven to be floats
+    mul_float,      // name left right, all proven to be floats
+    div_float,      // name left right, all proven to be floats
+    concat_string,  // name left right, all proven to be strings
+    assign_constant, // name left right, folded to the constant it always comes out as (operation kept in case that goes wrong)
+    finish          // Always the last instruction, so running off the end needs no bounds check
+};
+
+struct Keyword {
+    std::string_view name;
+    Opcode opcode;
+};
+
+// Every keyword and its aliases, because one name per thing would be too easy
+constexpr Keyword keywords[] = {
+    { "int", Opcode::declare_int },
+    { "whole_number", Opcode::declare_int },
+    { "float", Opcode::declare_float },
+    { "fake_or_real_number", Opcode::declare_float },
+    { "char", Opcode::declare_char },
+    { "idk_ascii_character", Opcode::declare_char },
+    { "string", Opcode::declare_string },
+    { "letters", Opcode::declare_string },
+    { "call", Opcode::call },
+    { "literally_just_call", Opcode::call },
+    { "goto", Opcode::go_to },
+    { "literally_just_go", Opcode::go_to },
+    { "jmp", Opcode::jmp },
+    { "return", Opcode::go_back },
+    { "goback", Opcode::go_back },
+    { "scan", Opcode::scan },
+    { "beg", Opcode::scan },
+    { "print", Opcode::print },
+    { "seg", Opcode::print },
+    { "delete", Opcode::obliterate },
+    { "obliterate", Opcode::obliterate },
+    { "explode", Opcode::obliterate },
+    { "branch", Opcode::branch },
+    { "exists", Opcode::exists },
+    { "local", Opcode::make_local },
+    { "mine", Opcode::make_local },
+    { "exit", Opcode::escape },
+    { "escape_the_torture", Opcode::escape }
+};
+
+constexpr size_t keyword_table_size = 64;
+
+// Length, first and last character are enough to tell every keyword apart, the seed spreads them out
+constexpr size_t keyword_hash(std::string_view word, uint32_t seed)
+{
+    uint32_t hash = seed;
+    hash = (hash ^ (uint32_t)word.size()) * 16777619u;
+    hash = (hash ^ (unsigned char)word.front()) * 16777619u;
+    hash = (hash ^ (unsigned char)word.back()) * 16777619u;
+    return (hash ^ (hash >> 16)) % keyword_table_size;
+}
+
+// Try seeds until no two keywords share a bucket, the compiler does the trying
+constexpr uint32_t find_keyword_seed()
+{
+    for (uint32_t seed = 2166136261u;; seed++)
+    {
+        bool taken[keyword_table_size] = {};
+        bool perfect = true;
+        for (const Keyword &keyword : keywords)
+        {
+            size_t bucket = keyword_hash(keyword.name, seed);
+            if (taken[bucket])
+            {
+                perfect = false;
+                break;
+            }
+            taken[bucket] = true;
+        }
+        if (perfect) return seed;
+    }
+}
+
+constexpr uint32_t keyword_seed = find_keyword_seed();
+
+// Bucket to index into keywords, -1 for empty buckets
+constexpr std::array<signed char, keyword_table_size> keyword_table = [] {
+    std::array<signed char, keyword_table_size> table = {};
+    table.fill(-1);
+    for (size_t k = 0; k < std::size(keywords); k++)
+    {
+        table[keyword_hash(keywords[k].name, keyword_seed)] = (signed char)k;
+    }
+    return table;
+}();
+
+// One hash and one compare, nullptr if the word is not a keyword
+constexpr const Keyword *find_keyword(std::string_view word)
+{
+    if (word.empty()) return nullptr;
+    signed char index = keyword_table[keyword_hash(word, keyword_seed)];
+    if (index < 0 || keywords[index].name != word) return nullptr;
+    return &keywords[index];
+}
+
+static_assert(find_keyword("escape_the_torture")->opcode == Opcode::escape, "Keyword table is broken");
+static_assert(find_keyword("add_return_value") == nullptr, "Keyword table is broken");
+
+// --------------------------------
+// Compiled program
+// --------------------------------
+
+struct Instruction {
+    Opcode opcode = Opcode::finish;
+    size_t operands[3] = { (size_t)-1, (size_t)-1, (size_t)-1 };
+    std::string text = {};
+    char operation = 0;         // Operator of assign_binary
+    size_t line = 0;            // Index into lines, for diagnostics and jmp
+    size_t target = (size_t)-1; // Where a jump lands (the label instruction, since i++ steps over it), -1 if nowhere
+    Variable constant = {};     // What assign_constant stores, or the literal a declaration falls back to
+    std::vector<size_t> arguments = {}; // Slots a call passes, or the parameters a label takes
+};
+
+struct Program {
+    std::vector<Instruction> instructions;
+    std::unordered_map<std::string, size_t> labels;         // Label name to instruction index
+    std::vector<std::pair<size_t, std::string>> complaints; // Diagnosed while loading (line, what), so --emit-cpp can say them again
+};
+
+// --------------------------------
+// Compiled program cache (filename.lsmc)
+// --------------------------------
+
+// Bump when anything below or the meaning of an opcode changes, old caches get thrown out
+constexpr uint32_t cache_version = 2;
+constexpr char cache_magic[8] = { 'L', 'S', 'M', 'C', 'A', 'C', 'H', 'E' };
+
+constexpr uint64_t Fnv(const void *data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+    for (size_t k = 0; k < size; k++) hash = (hash ^ ((const unsigned char *)data)[k]) * 1099511628211ull;
+    return hash;
+}
+
+// Everything the file is made of is flat, fixed width and offsets into pools, so it could be mapped and read as is
+// Slots are indices into the cache's own names, they become real slots by interning those names in order
+struct CachedString {
+    uint64_t offset; // Into chars
+    uint64_t size;
+};
+
+struct CachedInstruction {
+    uint64_t operands[3];
+    uint64_t line;
+    uint64_t target;
+    CachedString text;
+    uint64_t arguments_offset; // Into slots
+    uint64_t arguments_count;
+    CachedString constant_string;
+    uint32_t constant_value; // int, float or char, whatever constant_type says
+    uint8_t opcode;
+    char operation;
+    uint8_t constant_type;
+    uint8_t constant_live;
+};
+
+struct CachedLabel {
+    CachedString name;
+    uint64_t index;
+};
+
+// Goes first, anything that doesn't match means the cache is someone else's or from another time
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t opcodes;          // How many opcodes this build has
+    uint32_t instruction_size; // sizeof(CachedInstruction)
+    uint32_t max_arguments;    // MAX_CALL_ARGUMENTS, parameters past it were cut off while compiling
+    uint64_t source_hash;      // Fnv of the source lines
+    uint64_t source_lines;
+    uint64_t instructions;     // How many of each thing comes after
+    uint64_t labels;
+    uint64_t names;
+    uint64_t slots;
+    uint64_t chars;
+    uint64_t payload_hash;     // Fnv of everything after the header, so a half written cache doesn't get run
+};
+
+static_assert(std::is_trivially_copyable_v<CachedInstruction> && std::is_trivially_copyable_v<CacheHeader>, "The cache has to be plain bytes");
+
+// How deep calls can nest before it counts as running away, --max-depth changes it
+#ifndef MAX_CALL_DEPTH
+#define MAX_CALL_DEPTH 10000
+#endif
+
+// Most parameters a label can take, every frame has room for this many
+#ifndef MAX_CALL_ARGUMENTS
+#define MAX_CALL_ARGUMENTS 4
+#endif
+
+// Locals all frames together can have at once
+#ifndef MAX_FRAME_LOCALS
+#define MAX_FRAME_LOCALS 16384
+#endif
+
+// Bytes all frames together can use for long local strings, past that they go on the heap like everyone else
+#ifndef FRAME_ARENA_SIZE
+#define FRAME_ARENA_SIZE (256 * 1024)
+#endif
+
+// Where each call came from, so return knows where to go back to
+// Parameters and locals are the callee's own while it runs, the frame keeps what they held before and puts it back on return
+// Everything exists up front so calling never allocates, locals and their strings are bumped off one stack each and released in one go
+class CallStack {
+public:
+    struct Frame {
+        size_t from;   // The call instruction
+        size_t result; // Slot return gives the value to, -1 if the call didn't ask for one
+        size_t saved;  // How many parameters were set aside
+        size_t locals; // Where this frame's locals start
+        size_t arena;  // Where this frame's strings start
+    };
+
+    explicit CallStack(size_t depth)
+        : frames(std::make_unique<Frame[]>(depth)), saved(std::make_unique<Saved[]>(depth * MAX_CALL_ARGUMENTS)), locals(std::make_unique<Saved[]>(MAX_FRAME_LOCALS)), arena(std::make_unique<char[]>(FRAME_ARENA_SIZE)), depth(depth) {}
+
+    // Hands the arguments of the call at from to the parameters of its label, false when it is already as deep as it goes
+    bool push(const std::vector<Instruction> &instructions, size_t from, Variable *variables)
+    {
+        if (top == depth) return false;
+        const Instruction &call = instructions[from];
+        const std::vector<size_t> &parameters = instructions[call.target].arguments;
+        Saved *save = &saved[top * MAX_CALL_ARGUMENTS];
+        for (size_t k = 0; k < parameters.size(); k++)
+        {
+            save[k].slot = parameters[k];
+            save[k].value = std::move(variables[parameters[k]]);
+        }
+        for (size_t k = 0; k < parameters.size(); k++)
+        {
+            Variable &parameter = variables[parameters[k]];
+            if (k >= call.arguments.size())
+            {
+                parameter = Variable(); // Not passed, so it doesn't exist
+                continue;
+            }
+            // An argument that is itself a parameter was just set aside
+            const Variable *argument = &variables[call.arguments[k]];
+            for (size_t j = 0; j < parameters.size(); j++)
+            {
+                if (parameters[j] == call.arguments[k]) argument = &save[j].value;
+            }
+            parameter = *argument;
+        }
+        frames[top++] = Frame { from, call.operands[0], parameters.size(), locals_top, arena_top };
+        return true;
+    }
+
+    // Puts the locals and then the parameters back the way the caller had them
+    Frame pop(Variable *variables)
+    {
+        Frame frame = frames[--top];
+        while (locals_top > frame.locals)
+        {
+            Saved &local = locals[--locals_top];
+            variables[local.slot] = std::move(local.value);
+        }
+        arena_top = frame.arena;
+        Saved *save = &saved[top * MAX_CALL_ARGUMENTS];
+        for (size_t k = frame.saved; k-- > 0;) variables[save[k].slot] = std::move(save[k].value);
+        return frame;
+    }
+
+    // Sets slot aside until the current frame returns and leaves it not existing, false when there is no room
+    // Already one of this frame's locals means nothing to do
+    bool local(size_t slot, Variable *variables)
+    {
+        if (is_local(slot)) return true;
+        if (locals_top == MAX_FRAME_LOCALS) return false;
+        locals[locals_top++] = Saved { slot, std::move(variables[slot]) };
+        variables[slot] = Variable();
+        return true;
+    }
+
+    bool is_local(size_t slot) const
+    {
+        for (size_t k = frames[top - 1].locals; k < locals_top; k++)
+        {
+            if (locals[k].slot == slot) return true;
+        }
+        return false;
+    }
+
+    // Room for a local string until the current frame returns, nullptr when the arena is full
+    char *allocate(size_t size)
+    {
+        if (FRAME_ARENA_SIZE - arena_top < size) return nullptr;
+        char *memory = &arena[arena_top];
+        arena_top += size;
+        return memory;
+    }
+
+    // Returning from this frame only has to pop it, nothing to put back or give back
+    bool bare() const
+    {
+        const Frame &frame = back();
+        return frame.saved == 0 && frame.result == (size_t)-1 && locals_top == frame.locals;
+    }
+
+    const Frame &back() const
+    {
+        return frames[top - 1];
+    }
+
+    bool empty() const
+    {
+        return top == 0;
+    }
+
+    size_t size() const
+    {
+        return top;
+    }
+
+    size_t capacity() const
+    {
+        return depth;
+    }
+
+private:
+    struct Saved {
+        size_t slot;
+        Variable value;
+    };
+
+    std::unique_ptr<Frame[]> frames;
+    std::unique_ptr<Saved[]> saved; // MAX_CALL_ARGUMENTS per frame
+    std::unique_ptr<Saved[]> locals;
+    std::unique_ptr<char[]> arena;
+    size_t depth;
+    size_t top = 0;
+    size_t locals_top = 0;
+    size_t arena_top = 0;
+};
+
+// call right before return doesn't need a frame, the callee's return goes straight back to whoever called this
+// Unless nobody did (return has to get the chance to complain) or there is anything to pass, give back or put back
+inline bool IsTailCall(const std::vector<Instruction> &instructions, size_t k, const CallStack &stack)
+{
+    const Instruction &call = instructions[k];
+    const Instruction &next = instructions[k + 1];
+    return next.opcode == Opcode::go_back && next.operands[0] == (size_t)-1 && !stack.empty() && stack.bare()
+        && call.arguments.empty() && call.operands[0] == (size_t)-1 && instructions[call.target].arguments.empty();
+}
+
+// --------------------------------
+// Tracing (--trace)
+// --------------------------------
+
+// One instruction that ran, 24 bytes no matter what it was
+struct TraceRecord {
+    uint64_t tick;        // Timestamp counter when it started (rdtsc, steady_clock nanoseconds where there is none)
+    uint32_t instruction; // Index into the program
+    uint32_t slot;        // operands[0], the variable it touched, -1 if nothing
+    uint32_t line;        // Index into lines, so the decoder doesn't have to compile anything
+    uint16_t file;        // Index into the file table after the header
+    uint8_t opcode;
+    uint8_t unused;
+};
+
+static_assert(sizeof(TraceRecord) == 24, "Trace records are supposed to be small");
+
+constexpr uint32_t trace_version = 1;
+constexpr char trace_magic[8] = { 'L', 'S', 'M', 'T', 'R', 'A', 'C', 'E' };
+
+// Then how many files, each one as its length and name, then chunks until the end
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t files;
+};
+
+// A chunk is one dump of one thread's ring, count records right after it
+struct TraceChunk {
+    uint32_t thread;
+    uint32_t count;
+};
+
+inline uint64_t trace_ticks()
+{
+#if TRACE_RDTSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Each thread fills its own ring and writes the whole thing out in one write() when it's full, at exit, and when something kills us
+// Everything on the way out of a signal handler is a plain write() of memory that's already there
+class TraceRecorder {
+public:
+    static constexpr size_t capacity = TRACE_RING_SIZE;
+
+    // The chunk header sits right in front of the records so the two go out together
+    struct Ring {
+        TraceChunk chunk = {};
+        TraceRecord records[capacity];
+
+        ~Ring();
+
+        void record(size_t index, const Instruction &instruction, uint16_t file);
+    };
+
+    bool enabled() const { return fd >= 0; }
+
+    // Starts the file and the handlers, files are what the file indices in the records mean
+    bool open(const std::string &path, const std::vector<std::string> &files)
+    {
+#ifndef _WIN32
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+#else
+        fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_APPEND | _O_BINARY, 0644);
+#endif
+        if (fd < 0) return false;
+        std::string head(sizeof(TraceHeader), '\0');
+        TraceHeader header = {};
+        std::memcpy(header.magic, trace_magic, sizeof(trace_magic));
+        header.version = trace_version;
+        header.record_size = sizeof(TraceRecord);
+        header.files = (uint32_t)files.size();
+        std::memcpy(head.data(), &header, sizeof(header));
+        for (const std::string &file : files)
+        {
+            uint32_t length = (uint32_t)file.size();
+            head.append((const char *)&length, sizeof(length));
+            head += file;
+        }
+        if (!Write(head.data(), head.size()))
+        {
+            close();
+            return false;
+        }
+#ifndef _WIN32
+        struct sigaction action = {};
+        action.sa_handler = Dying;
+        action.sa_flags = SA_RESETHAND; // Dump once, then let the signal do what it was going to do
+        sigemptyset(&action.sa_mask);
+        for (int signal : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGINT, SIGTERM, SIGHUP }) sigaction(signal, &action, nullptr);
+#else
+        for (int signal : { SIGSEGV, SIGFPE, SIGILL, SIGABRT, SIGINT, SIGTERM }) std::signal(signal, Dying);
+#endif
+        return true;
+    }
+
+    void close()
+    {
+        if (fd < 0) return;
+#ifndef _WIN32
+        ::close(fd);
+#else
+        _close(fd);
+#endif
+        fd = -1;
+    }
+
+    // The calling thread's ring, made the first time it asks
+    Ring &ring()
+    {
+        if (!current)
+        {
+            static std::atomic<uint32_t> threads = 0;
+            current = std::make_unique<Ring>();
+            current->chunk.thread = threads++;
+        }
+        return *current;
+    }
+
+    // Writes out whatever the ring has so far and empties it
+    void dump(Ring &ring)
+    {
+        if (fd < 0 || !ring.chunk.count) return;
+        Write((const char *)&ring.chunk, sizeof(TraceChunk) + ring.chunk.count * sizeof(TraceRecord));
+        ring.chunk.count = 0;
+    }
+
+private:
+    int fd = -1;
+    static inline thread_local std::unique_ptr<Ring> current;
+
+    bool Write(const char *data, size_t size)
+    {
+        while (size)
+        {
+#ifndef _WIN32
+            ssize_t written = ::write(fd, data, size);
+#else
+            int written = _write(fd, data, (unsigned int)size);
+#endif
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    static void Dying(int signal);
+} trace;
+
+// A thread going away takes its last records out with it
+inline TraceRecorder::Ring::~Ring()
+{
+    trace.dump(*this);
+}
+
+inline void TraceRecorder::Ring::record(size_t index, const Instruction &instruction, uint16_t file)
+{
+    records[chunk.count++] = { trace_ticks(), (uint32_t)index, (uint32_t)instruction.operands[0], (uint32_t)instruction.line, file, (uint8_t)instruction.opcode, 0 };
+    if (chunk.count == capacity) trace.dump(*this);
+}
+
+// Whatever the dying thread had, then the same death as without us
+inline void TraceRecorder::Dying(int signal)
+{
+    if (current) trace.dump(*current);
+#ifdef _WIN32
+    std::signal(signal, SIG_DFL);
+#endif
+    std::raise(signal);
+}
+
+// Prints a --trace file the way --debug would have printed it as it ran, sources are read again from where the header says
+// Threads other than the first one get their number in front, they come out one ring at a time
+inline bool DecodeTrace(const std::string &path)
+{
+    MappedFile file(path);
+    std::string_view data = file.text();
+    TraceHeader header = {};
+    if (file.fail() || data.size() < sizeof(header)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, trace_magic, sizeof(trace_magic)) != 0 || header.version != trace_version || header.record_size != sizeof(TraceRecord)) return false;
+
+    struct Source {
+        std::string name;
+        std::unique_ptr<MappedFile> mapped;
+        std::vector<std::string_view> lines;
+        int width = 1;
+    };
+    std::vector<Source> sources;
+    size_t offset = sizeof(header);
+    for (uint32_t f = 0; f < header.files; f++)
+    {
+        uint32_t length = 0;
+        if (data.size() - offset < sizeof(length)) return false;
+        std::memcpy(&length, data.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (data.size() - offset < length) return false;
+        sources.push_back({ std::string(data.substr(offset, length)), nullptr, {}, 1 });
+        offset += length;
+    }
+
+    while (data.size() - offset >= sizeof(TraceChunk))
+    {
+        TraceChunk chunk = {};
+        std::memcpy(&chunk, data.data() + offset, sizeof(chunk));
+        offset += sizeof(chunk);
+        // Cut short by whatever killed it, the records that did make it still count
+        size_t count = std::min<size_t>(chunk.count, (data.size() - offset) / sizeof(TraceRecord));
+        for (size_t r = 0; r < count; r++, offset += sizeof(TraceRecord))
+        {
+            TraceRecord record = {};
+            std::memcpy(&record, data.data() + offset, sizeof(record));
+            if ((Opcode)record.opcode == Opcode::finish || (Opcode)record.opcode == Opcode::make_local) continue;
+            if (record.file >= sources.size()) return false;
+            Source &source = sources[record.file];
+            if (!source.mapped)
+            {
+                source.mapped = std::make_unique<MappedFile>(source.name);
+                source.lines = split_lines(source.mapped->text());
+                source.width = source.lines.empty() ? 1 : (int)std::log10(source.lines.size()) + 1;
+            }
+            if (chunk.thread) std::cout << "[" << chunk.thread << "] ";
+            std::cout << green << source.name << reset << ": # " << std::setw(source.width) << green << record.line + 1 << reset << " : ";
+            if (record.line < source.lines.size()) std::cout << source.lines[record.line] << '\n';
+            else std::cout << red << "(that line isn't there anymore)" << reset << '\n';
+        }
+        if (count < chunk.count) break;
+    }
+    return true;
+}
+
+// --------------------------------
+// Profiling (--profile)
+// --------------------------------
+
+// Where the time went, by line and by label, and by whole call stacks for flame graphs
+// Each instruction gets the ticks from when it started until the next one did, calls and returns are seen by the call stack changing size
+class Profiler {
+public:
+    // Starts counting for a file, depth is how deep the call stack already was
+    void start(const std::string &file, size_t lines, size_t depth)
+    {
+        this->file = file;
+        line_stats.assign(lines, {});
+        base = depth;
+        size_t root = Label("");
+        labels[root].calls++;
+        labels[root].active++;
+        frames = { Frame { Child((size_t)-1, root), root, trace_ticks() } };
+        called = (size_t)-1;
+        last_line = (size_t)-1;
+        last = frames.back().start;
+    }
+
+    // Right before instruction (program[i]) runs
+    void step(size_t i, const Instruction &instruction, const std::vector<Instruction> &program, const CallStack &stack)
+    {
+        uint64_t now = trace_ticks();
+        Charge(now);
+        // A call that got to its label without pushing anything was a tail call, the callee takes over the caller's frame
+        if (called != (size_t)-1 && stack.size() == called_depth && i == program[called].target + 1 && frames.size() > 1)
+        {
+            Leave(now);
+            Enter(program[called].text, now);
+        }
+        called = instruction.opcode == Opcode::call ? i : (size_t)-1;
+        called_depth = stack.size();
+        size_t depth = stack.size() > base ? stack.size() - base : 0;
+        while (frames.size() - 1 > depth) Leave(now);
+        while (frames.size() - 1 < depth) Enter(program[stack.back().from].text, now);
+        if (instruction.line < line_stats.size())
+        {
+            if (instruction.opcode != Opcode::make_local) line_stats[instruction.line].hits++; // Its declaration is the same line running
+            last_line = instruction.line;
+        }
+        else last_line = (size_t)-1;
+        last = now;
+    }
+
+    // The file is done, whatever is still called returns now
+    void finish(const std::vector<std::string_view> &lines)
+    {
+        if (frames.empty()) return;
+        uint64_t now = trace_ticks();
+        Charge(now);
+        while (!frames.empty()) Leave(now);
+        // The lines go away with the file, the few that ran are kept
+        for (size_t k = 0; k < line_stats.size(); k++)
+        {
+            if (line_stats[k].hits) rows.push_back({ file, k, std::string(k < lines.size() ? lines[k] : ""), line_stats[k] });
+        }
+    }
+
+    // Flat report into path, folded stacks into path.folded, false if either couldn't be written
+    bool write(const std::string &path) const
+    {
+        const char *unit = TRACE_RDTSC ? "cycles (rdtsc)" : "nanoseconds";
+        uint64_t total = 0;
+        for (const Row &row : rows) total += row.stats.ticks;
+        auto Percent = [total](uint64_t ticks) { return total ? 100.0 * (double)ticks / (double)total : 0.0; };
+
+        std::vector<const Row *> by_ticks;
+        for (const Row &row : rows) by_ticks.push_back(&row);
+        std::stable_sort(by_ticks.begin(), by_ticks.end(), [](const Row *a, const Row *b) { return a->stats.ticks > b->stats.ticks; });
+        std::vector<const LabelStats *> by_inclusive;
+        for (const LabelStats &label : labels) by_inclusive.push_back(&label);
+        std::stable_sort(by_inclusive.begin(), by_inclusive.end(), [](const LabelStats *a, const LabelStats *b) { return a->inclusive > b->inclusive; });
+
+        std::ofstream report(path);
+        report << "Everything is in " << unit << ", " << total << " of them in total\n\n";
+        report << "Lines, slowest first\n";
+        report << std::setw(14) << "self" << std::setw(8) << "%" << std::setw(12) << "hits" << "  where\n";
+        for (const Row *row : by_ticks)
+        {
+            report << std::setw(14) << row->stats.ticks << std::setw(8) << std::fixed << std::setprecision(2) << Percent(row->stats.ticks) << std::setw(12) << row->stats.hits;
+            report << "  " << row->file << ":" << row->line + 1 << ": " << row->text << '\n';
+        }
+        report << "\nLabels, most inclusive first (a file is its own label, for the lines outside of any call)\n";
+        report << std::setw(14) << "inclusive" << std::setw(8) << "%" << std::setw(14) << "self" << std::setw(12) << "calls" << "  label\n";
+        for (const LabelStats *label : by_inclusive)
+        {
+            report << std::setw(14) << label->inclusive << std::setw(8) << std::fixed << std::setprecision(2) << Percent(label->inclusive) << std::setw(14) << label->self << std::setw(12) << label->calls;
+            report << "  " << label->file << (label->name.empty() ? "" : ":") << label->name << '\n';
+        }
+        report.close();
+
+        // One line per stack that ever spent anything by itself: file;label;label ticks
+        std::ofstream folded(path + ".folded");
+        for (const Node &node : nodes)
+        {
+            if (!node.self) continue;
+            std::vector<std::string_view> stack;
+            for (const Node *at = &node;; at = &nodes[at->parent])
+            {
+                const LabelStats &label = labels[at->label];
+                stack.push_back(label.name.empty() ? std::string_view(label.file) : std::string_view(label.name));
+                if (at->parent == (size_t)-1) break;
+            }
+            for (size_t k = stack.size(); k-- > 0;) folded << stack[k] << (k ? ";" : " ");
+            folded << node.self << '\n';
+        }
+        folded.close();
+        return !report.fail() && !folded.fail();
+    }
+
+private:
+    struct LineStats {
+        uint64_t hits = 0;
+        uint64_t ticks = 0;
+    };
+
+    struct Row {
+        std::string file;
+        size_t line;
+        std::string text;
+        LineStats stats;
+    };
+
+    struct LabelStats {
+        std::string file;
+        std::string name; // Empty for the file itself
+        uint64_t calls = 0;
+        uint64_t self = 0;
+        uint64_t inclusive = 0; // Only the outermost call of a recursive label counts, or it would count itself twice
+        size_t active = 0;      // How many times it's on the stack right now
+    };
+
+    // One label reached through one exact stack of calls
+    struct Node {
+        size_t parent;
+        size_t label;
+        uint64_t self = 0;
+    };
+
+    struct Frame {
+        size_t node;
+        size_t label;
+        uint64_t start;
+    };
+
+    std::string file;
+    std::vector<LineStats> line_stats; // This file's, by line
+    std::vector<Row> rows;             // Every file's that are done
+    std::vector<LabelStats> labels;
+    std::unordered_map<std::string, size_t> label_index; // file, a zero, then the name
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, size_t> children; // Parent node and label to node
+    std::vector<Frame> frames;                     // What's called right now, the file at the bottom
+    size_t base = 0;
+    size_t called = (size_t)-1; // The call that ran last step, if it was one
+    size_t called_depth = 0;    // How deep the stack was when it did
+    size_t last_line = (size_t)-1;
+    uint64_t last = 0;
+
+    size_t Label(std::string_view name)
+    {
+        std::string key = file;
+        key += '\0';
+        key += name;
+        auto found = label_index.find(key);
+        if (found != label_index.end()) return found->second;
+        label_index.emplace(std::move(key), labels.size());
+        labels.push_back({ file, std::string(name) });
+        return labels.size() - 1;
+    }
+
+    size_t Child(size_t parent, size_t label)
+    {
+        uint64_t key = (uint64_t)parent << 32 ^ label;
+        auto found = children.find(key);
+        if (found != children.end()) return found->second;
+        children.emplace(key, nodes.size());
+        nodes.push_back({ parent, label });
+        return nodes.size() - 1;
+    }
+
+    // The time since the last step belongs to the line that was running and whoever it ran in
+    void Charge(uint64_t now)
+    {
+        uint64_t ticks = now - last;
+        if (last_line != (size_t)-1) line_stats[last_line].ticks += ticks;
+        nodes[frames.back().node].self += ticks;
+        labels[frames.back().label].self += ticks;
+        last = now;
+    }
+
+    void Enter(std::string_view name, uint64_t now)
+    {
+        size_t label = Label(name);
+        labels[label].calls++;
+        labels[label].active++;
+        frames.push_back({ Child(frames.back().node, label), label, now });
+    }
+
+    void Leave(uint64_t now)
+    {
+        Frame frame = frames.back();
+        frames.pop_back();
+        LabelStats &label = labels[frame.label];
+        if (--label.active == 0) label.inclusive += now - frame.start;
+    }
+};
+
+// --------------------------------
+// Workers (--jobs)
+// --------------------------------
+
+// Every file runs in a forked copy of the whole interpreter, a few at a time, so no file ever sees another one's variables, labels or call stack
+// Workers print into temp files, which are passed on in file order as soon as a file and everything before it is done
+class Workers {
+public:
+    Workers(size_t jobs, size_t kinds) : jobs(jobs), counts(kinds) {}
+
+    // The file index in each worker, nullopt back in the parent once every file is done
+    std::optional<size_t> run(const std::vector<std::string> &filenames)
+    {
+#ifndef _WIN32
+        // Each file gets all of stdin for itself, so it's read once up front (unless a human is typing it)
+        std::string input;
+        if (!isatty(STDIN_FILENO)) input = ReadAll(STDIN_FILENO);
+
+        std::vector<Job> queue(filenames.size());
+        std::unordered_map<pid_t, size_t> running;
+        size_t next = 0;
+        size_t emitted = 0;
+        while (emitted < queue.size())
+        {
+            while (running.size() < jobs && next < queue.size())
+            {
+                Job &job = queue[next];
+                job.out = std::tmpfile();
+                job.err = std::tmpfile();
+                job.report = std::tmpfile();
+                // Anything still buffered would come out of every worker too
+                output.pubsync();
+                std::cerr.flush();
+                pid_t pid = job.out && job.err && job.report ? fork() : -1;
+                if (pid == 0)
+                {
+                    Become(job, input);
+                    return next;
+                }
+                if (pid < 0) job.done = true; // Never ran, status stays failed
+                else running.emplace(pid, next);
+                next++;
+            }
+
+            if (!running.empty())
+            {
+                int status = 0;
+                pid_t pid = waitpid(-1, &status, 0);
+                if (pid < 0 && errno == EINTR) continue;
+                if (pid < 0)
+                {
+                    // Lost track of them somehow, whatever they did doesn't count
+                    for (const auto &[lost, index] : running) queue[index].done = true;
+                    running.clear();
+                }
+                auto found = running.find(pid);
+                if (found != running.end())
+                {
+                    queue[found->second].status = status;
+                    queue[found->second].done = true;
+                    running.erase(found);
+                }
+            }
+            while (emitted < queue.size() && queue[emitted].done)
+            {
+                Emit(queue[emitted], filenames[emitted]);
+                emitted++;
+            }
+        }
+#else
+        (void)filenames;
+#endif
+        return std::nullopt;
+    }
+
+    // Worker side, how many of each witch its file saw (the parent adds them up for --batch)
+    void report(const size_t *kinds)
+    {
+#ifndef _WIN32
+        if (report_fd >= 0 && ::write(report_fd, kinds, counts.size() * sizeof(size_t)) < 0) report_fd = -1;
+#else
+        (void)kinds;
+#endif
+    }
+
+    // Parent side, every worker's witches added up
+    const std::vector<size_t> &witches() const { return counts; }
+
+    // Zero when every file ran to the end without a single complaint
+    int status() const { return failed ? 1 : 0; }
+
+private:
+    struct Job {
+        std::FILE *out = nullptr;
+        std::FILE *err = nullptr;
+        std::FILE *report = nullptr;
+        int status = -1;
+        bool done = false;
+    };
+
+    size_t jobs;
+    std::vector<size_t> counts;
+    bool failed = false;
+    int report_fd = -1;
+
+#ifndef _WIN32
+    static std::string ReadAll(int fd)
+    {
+        std::string data;
+        char chunk[1 << 16];
+        for (;;)
+        {
+            ssize_t got = ::read(fd, chunk, sizeof(chunk));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return data;
+            data.append(chunk, (size_t)got);
+        }
+    }
+
+    // Turns this process into the worker for job, stdin, stdout and stderr all its own
+    void Become(Job &job, const std::string &input)
+    {
+        std::FILE *in = std::tmpfile();
+        if (in)
+        {
+            if (!input.empty()) std::fwrite(input.data(), 1, input.size(), in);
+            std::fflush(in);
+            std::rewind(in);
+            dup2(fileno(in), STDIN_FILENO);
+        }
+        dup2(fileno(job.out), STDOUT_FILENO);
+        dup2(fileno(job.err), STDERR_FILENO);
+        output.reopened();
+        report_fd = fileno(job.report);
+    }
+
+    // Passes on what the worker printed, then what it complained about, then how it went
+    void Emit(Job &job, const std::string &filename)
+    {
+        auto Copy = [](std::FILE *file, std::ostream &to) {
+            if (!file) return;
+            std::rewind(file);
+            char chunk[1 << 16];
+            size_t got;
+            while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) to.write(chunk, (std::streamsize)got);
+        };
+        Copy(job.out, std::cout);
+        std::cout.flush();
+        Copy(job.err, std::cerr);
+
+        if (job.report)
+        {
+            std::rewind(job.report);
+            std::vector<size_t> kinds(counts.size());
+            if (std::fread(kinds.data(), sizeof(size_t), kinds.size(), job.report) == kinds.size())
+            {
+                for (size_t k = 0; k < kinds.size(); k++) counts[k] += kinds[k];
+            }
+        }
+
+        if (job.status == -1) std::cout << "Couldn't even start a worker for " << red << filename << reset << ". Skipped, not my fault this time\n";
+        else if (WIFSIGNALED(job.status)) std::cout << red << filename << reset << " took its worker down with it (signal " << WTERMSIG(job.status) << ")\n";
+        if (!WIFEXITED(job.status) || WEXITSTATUS(job.status) != 0) failed = true;
+
+        for (std::FILE *file : { job.out, job.err, job.report })
+        {
+            if (file) std::fclose(file);
+        }
+        job.out = job.err = job.report = nullptr;
+    }
+#endif
+};
+
+// --------------------------------
+// JIT
+// --------------------------------
+
+// Machine code only for x86-64 with mmap, everyone else keeps interpreting
+#ifndef JIT_SUPPORTED
+#if defined(__x86_64__) && !defined(_WIN32)
+#define JIT_SUPPORTED true
+#else
+#define JIT_SUPPORTED false
+#endif
+#endif
+
+// How many jumps a label takes before it is worth compiling
+#ifndef JIT_THRESHOLD
+#define JIT_THRESHOLD 100
+#endif
+
+// Turns the instructions after a hot label into x86-64, one fixed template per opcode
+// Whatever has no template (declarations, scan, print, delete, strings...) ends the region and the interpreter takes over
+class JitCompiler {
+public:
+    // Set on what machine code returns when it left at a label, so that label's own machine code can take over
+    static constexpr size_t chained = (size_t)1 << 63;
+
+    bool enabled = false;
+
+    JitCompiler(const Program &program, CallStack &goneto_stack)
+        : program(program), goneto_stack(goneto_stack), regions(program.instructions.size()) {}
+
+    JitCompiler(const JitCompiler &) = delete;
+    JitCompiler &operator=(const JitCompiler &) = delete;
+
+    ~JitCompiler()
+    {
+#if JIT_SUPPORTED
+        for (Region &region : regions)
+        {
+            if (region.code) munmap((void *)region.code, region.size);
+        }
+#endif
+    }
+
+    // Right after a jump landed on label, returns the i the interpreter continues from
+    size_t enter(size_t label, Variable *variables)
+    {
+        for (;;)
+        {
+            Region &region = regions[label];
+            if (!region.code)
+            {
+                if (region.failed || ++region.hits < JIT_THRESHOLD) return label;
+                if (!compile(label))
+                {
+                    region.failed = true;
+                    return label;
+                }
+            }
+            size_t next = region.code(variables, this);
+            if (!(next & chained)) return next;
+            label = next & ~chained;
+        }
+    }
+
+private:
+    // rbx = variables and r12 = this while it runs, returns the next i
+    using Native = size_t (*)(Variable *variables, JitCompiler *jit);
+
+    struct Region {
+        Native code = nullptr;
+        size_t size = 0;
+        uint32_t hits = 0;
+        bool failed = false; // Nothing worth compiling after this label
+    };
+
+    static constexpr size_t max_region = 4096;         // Instructions
+    static constexpr size_t max_slot = (size_t)1 << 26; // Anything past this doesn't fit in a disp32
+
+    const Program &program;
+    CallStack &goneto_stack;
+    std::vector<Region> regions; // Indexed by label instruction
+
+    // Machine code calls these for the stack, the rest it does itself
+    // Only for calls with nothing to pass, so there are no variables to touch
+    // False when the stack is full, the interpreter redoes the call and complains
+    static bool call(JitCompiler *jit, size_t from)
+    {
+        if (IsTailCall(jit->program.instructions, from, jit->goneto_stack)) return true;
+        return jit->goneto_stack.push(jit->program.instructions, from, nullptr);
+    }
+
+    // -1 when the interpreter has to do it, because there is nothing to go back to or the frame has something to put or give back
+    static size_t go_back(JitCompiler *jit)
+    {
+        if (jit->goneto_stack.empty() || !jit->goneto_stack.bare()) return (size_t)-1;
+        size_t i = jit->goneto_stack.pop(nullptr).from;
+        // Same clamp as the interpreter, for calls left over from another file
+        if (i >= jit->program.instructions.size() - 1) i = jit->program.instructions.size() - 2;
+        return i;
+    }
+
+    // Just enough of an x86-64 encoder for the templates, every memory operand is [rbx + disp32]
+    struct Assembler {
+        std::vector<unsigned char> code;
+
+        void bytes(std::initializer_list<unsigned char> list)
+        {
+            code.insert(code.end(), list);
+        }
+
+        void immediate(uint64_t value, size_t size)
+        {
+            for (size_t b = 0; b < size; b++) code.push_back((unsigned char)(value >> (8 * b)));
+        }
+
+        // Opcode, then ModRM with mod = 10 and rm = rbx, reg is the register or the /digit
+        void memory(std::initializer_list<unsigned char> opcode, unsigned char reg, size_t slot, size_t offset = 0)
+        {
+            bytes(opcode);
+            code.push_back(0x83 | reg << 3);
+            immediate(slot * sizeof(Variable) + offset, 4);
+        }
+
+        // jmp or jcc with rel32 left blank, returns where the blank is
+        size_t jump(std::initializer_list<unsigned char> opcode)
+        {
+            bytes(opcode);
+            immediate(0, 4);
+            return code.size() - 4;
+        }
+
+        void patch(size_t blank, size_t destination)
+        {
+            int32_t relative = (int32_t)(destination - (blank + 4));
+            std::memcpy(&code[blank], &relative, 4);
+        }
+    };
+
+    bool compile(size_t label)
+    {
+#if JIT_SUPPORTED
+        static_assert(offsetof(Variable, live) == offsetof(Variable, type) + 1, "Type and live are compared as one word");
+        const std::vector<Instruction> &instructions = program.instructions;
+        constexpr size_t tag = offsetof(Variable, type);
+        constexpr size_t live = offsetof(Variable, live);
+
+        Assembler a;
+        std::unordered_map<size_t, size_t> native; // Instruction to code offset, for jumps that stay inside
+        std::vector<std::pair<size_t, size_t>> deopts; // Blank, instruction the interpreter redoes
+        std::vector<std::pair<size_t, size_t>> jumps;  // Blank, label it lands on
+        std::vector<size_t> returns;                   // Blanks going to the epilogue with rax set
+
+        // Machine code gives up on this instruction, the interpreter runs it instead
+        auto Deopt = [&](size_t blank, size_t k) {
+            deopts.push_back({ blank, k });
+        };
+        // Jump to a label, -1 means the interpreter gets to complain about it
+        auto Goto = [&](size_t blank, size_t k, size_t target) {
+            if (target == (size_t)-1) Deopt(blank, k);
+            else jumps.push_back({ blank, target });
+        };
+        // Deopt unless the slot holds a variable of that type
+        auto Guard = [&](size_t slot, Variable::Type type, size_t k) {
+            a.memory({ 0x66, 0x81 }, 7, slot, tag); // cmp word [slot.type], live << 8 | type
+            a.immediate(0x100 | type, 2);
+            Deopt(a.jump({ 0x0F, 0x85 }), k); // jne
+        };
+        auto Return = [&](uint64_t value) {
+            a.bytes({ 0x48, 0xB8 }); // mov rax, value
+            a.immediate(value, 8);
+            returns.push_back(a.jump({ 0xE9 }));
+        };
+        auto CallHelper = [&](uint64_t helper) {
+            a.bytes({ 0x4C, 0x89, 0xE7 }); // mov rdi, r12
+            a.bytes({ 0x48, 0xB8 });       // mov rax, helper
+            a.immediate(helper, 8);
+            a.bytes({ 0xFF, 0xD0 }); // call rax
+        };
+
+        // push rbx, push r12, push r13 (only to keep calls aligned), mov rbx, rdi, mov r12, rsi
+        a.bytes({ 0x53, 0x41, 0x54, 0x41, 0x55, 0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4 });
+
+        size_t k = label;
+        for (; k < instructions.size() && k - label < max_region; k++)
+        {
+            const Instruction &instruction = instructions[k];
+            const size_t dest = instruction.operands[0];
+            const size_t left = instruction.operands[1];
+            const size_t right = instruction.operands[2];
+            bool addressable = true;
+            for (size_t operand : instruction.operands) addressable &= operand == (size_t)-1 || operand < max_slot;
+            if (!addressable) break;
+
+            Opcode opcode = instruction.opcode;
+            // Untyped arithmetic bets on ints and deopts if that was wrong
+            if (opcode == Opcode::assign_binary)
+            {
+                switch (instruction.operation)
+                {
+                    case '+': opcode = Opcode::add_int; break;
+                    case '-': opcode = Opcode::sub_int; break;
+                    case '*': opcode = Opcode::mul_int; break;
+                    case '/': opcode = Opcode::div_int; break;
+                    case '%': opcode = Opcode::mod_int; break;
+                }
+            }
+
+            size_t start = a.code.size();
+            switch (opcode)
+            {
+                case Opcode::label:
+                    break;
+
+                case Opcode::add_int:
+                case Opcode::sub_int:
+                case Opcode::mul_int:
+                case Opcode::div_int:
+                case Opcode::mod_int:
+                    Guard(dest, Variable::_int, k);
+                    Guard(left, Variable::_int, k);
+                    Guard(right, Variable::_int, k);
+                    a.memory({ 0x8B }, 0, left); // mov eax, [left]
+                    switch (opcode)
+                    {
+                        case Opcode::add_int: a.memory({ 0x03 }, 0, right); break;       // add eax, [right]
+                        case Opcode::sub_int: a.memory({ 0x2B }, 0, right); break;       // sub eax, [right]
+                        case Opcode::mul_int: a.memory({ 0x0F, 0xAF }, 0, right); break; // imul eax, [right]
+                        default:
+                            a.bytes({ 0x99 });            // cdq
+                            a.memory({ 0xF7 }, 7, right); // idiv dword [right]
+                            break;
+                    }
+                    a.memory({ 0x89 }, opcode == Opcode::mod_int ? 2 : 0, dest); // mov [dest], eax (or edx for the remainder)
+                    break;
+
+                case Opcode::add_float:
+                case Opcode::sub_float:
+                case Opcode::mul_float:
+                case Opcode::div_float:
+                {
+                    Guard(dest, Variable::_float, k);
+                    Guard(left, Variable::_float, k);
+                    Guard(right, Variable::_float, k);
+                    a.memory({ 0xF3, 0x0F, 0x10 }, 0, left); // movss xmm0, [left]
+                    unsigned char operation = opcode == Opcode::add_float ? 0x58 : opcode == Opcode::sub_float ? 0x5C : opcode == Opcode::mul_float ? 0x59 : 0x5E;
+                    a.memory({ 0xF3, 0x0F, operation }, 0, right); // addss/subss/mulss/divss xmm0, [right]
+                    a.memory({ 0xF3, 0x0F, 0x11 }, 0, dest);       // movss [dest], xmm0
+                    break;
+                }
+
+                case Opcode::assign_copy:
+                    // Same type on both sides and not a string, then it is just 4 bytes
+                    a.memory({ 0x66, 0x8B }, 0, dest, tag);   // mov ax, [dest.type]
+                    a.memory({ 0x66, 0x3B }, 0, left, tag);   // cmp ax, [left.type]
+                    Deopt(a.jump({ 0x0F, 0x85 }), k);         // jne
+                    a.bytes({ 0x84, 0xE4 });                  // test ah, ah
+                    Deopt(a.jump({ 0x0F, 0x84 }), k);         // jz
+                    a.bytes({ 0x66, 0x3D });                  // cmp ax, live string
+                    a.immediate(0x100 | Variable::_string, 2);
+                    Deopt(a.jump({ 0x0F, 0x84 }), k);         // je
+                    a.memory({ 0x8B }, 0, left);              // mov eax, [left]
+                    a.memory({ 0x89 }, 0, dest);              // mov [dest], eax
+                    break;
+
+                case Opcode::assign_constant:
+                    Guard(dest, instruction.constant.type, k);
+                    if (instruction.constant.type == Variable::_char)
+                    {
+                        a.memory({ 0xC6 }, 0, dest); // mov byte [dest], value
+                        a.immediate((unsigned char)instruction.constant.value_char, 1);
+                    }
+                    else
+                    {
+                        a.memory({ 0xC7 }, 0, dest); // mov dword [dest], value
+                        a.immediate((uint32_t)instruction.constant.value_int, 4);
+                    }
+                    break;
+
+                case Opcode::branch:
+                    Guard(dest, Variable::_int, k);
+                    a.memory({ 0x83 }, 7, dest); // cmp dword [dest], 0
+                    a.immediate(0, 1);
+                    Goto(a.jump({ 0x0F, 0x85 }), k, instruction.target); // jne
+                    break;
+
+                case Opcode::exists:
+                    a.memory({ 0x80 }, 7, dest, live); // cmp byte [dest.live], 0
+                    a.immediate(0, 1);
+                    Goto(a.jump({ 0x0F, 0x85 }), k, instruction.target); // jne
+                    break;
+
+                case Opcode::go_to:
+                    Goto(a.jump({ 0xE9 }), k, instruction.target);
+                    break;
+
+                case Opcode::call:
+                    if (instruction.target == (size_t)-1 || !instruction.arguments.empty() || dest != (size_t)-1 || !instructions[instruction.target].arguments.empty())
+                    {
+                        Deopt(a.jump({ 0xE9 }), k);
+                        break;
+                    }
+                    a.bytes({ 0x48, 0xBE }); // mov rsi, k
+                    a.immediate(k, 8);
+                    CallHelper((uint64_t)&JitCompiler::call);
+                    a.bytes({ 0x84, 0xC0 });          // test al, al
+                    Deopt(a.jump({ 0x0F, 0x84 }), k); // je
+                    Goto(a.jump({ 0xE9 }), k, instruction.target);
+                    break;
+
+                case Opcode::go_back:
+                    if (dest != (size_t)-1)
+                    {
+                        Deopt(a.jump({ 0xE9 }), k);
+                        break;
+                    }
+                    CallHelper((uint64_t)&JitCompiler::go_back);
+                    a.bytes({ 0x48, 0x83, 0xF8, 0xFF }); // cmp rax, -1
+                    Deopt(a.jump({ 0x0F, 0x84 }), k);    // je
+                    returns.push_back(a.jump({ 0xE9 }));
+                    break;
+
+                default:
+                    break;
+            }
+            if (a.code.size() == start && opcode != Opcode::label) break;
+            native[k] = start;
+        }
+
+        // A label followed by nothing compilable is not worth an mmap
+        if (k <= label + 1) return false;
+
+        // Fell off the end of the region, the interpreter continues from there
+        Return(k - 1);
+        for (auto [blank, at] : deopts)
+        {
+            a.patch(blank, a.code.size());
+            Return(at - 1);
+        }
+        std::unordered_map<size_t, size_t> exits; // Label to its exit stub
+        for (auto [blank, target] : jumps)
+        {
+            auto inside = native.find(target);
+            if (inside != native.end())
+            {
+                a.patch(blank, inside->second);
+                continue;
+            }
+            auto [exit, made] = exits.try_emplace(target, a.code.size());
+            if (made) Return(target | chained);
+            a.patch(blank, exit->second);
+        }
+        for (size_t blank : returns) a.patch(blank, a.code.size());
+        a.bytes({ 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3 }); // pop r13, pop r12, pop rbx, ret
+
+        // Written while writable, run while executable, never both
+        void *memory = mmap(nullptr, a.code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return false;
+        std::memcpy(memory, a.code.data(), a.code.size());
+        if (mprotect(memory, a.code.size(), PROT_READ | PROT_EXEC) != 0)
+        {
+            munmap(memory, a.code.size());
+            return false;
+        }
+        regions[label].code = (Native)memory;
+        regions[label].size = a.code.size();
+        return true;
+#else
+        (void)label;
+        return false;
+#endif
+    }
+};
+
+// --------------------------------
+// C++ emitter
+// --------------------------------
+
+// Goes on top of every --emit-cpp file, before the variables
+const char *const cpp_prelude_head = R"prelude(#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+const std::string reset = "\033[0m";
+const std::string red = "\033[31m";
+const std::string bold = "\033[1m";
+const std::string underline = "\033[4m";
+const std::string hide_cursor = "\033[?25l";
+const std::string show_cursor = "\033[?25h";
+
+// Same rules as lastsmall's Variable, without the tricks that keep it small
+struct Variable {
+    enum Type : unsigned char {
+        _int,
+        _float,
+        _char,
+        _string
+    };
+
+    Type type = _int;
+    bool live = false;
+    int value_int = 0;
+    float value_float = 0;
+    char value_char = 0;
+    std::string value_string;
+
+    static Variable of(int value) { Variable variable; variable.type = _int; variable.live = true; variable.value_int = value; return variable; }
+    static Variable of(float value) { Variable variable; variable.type = _float; variable.live = true; variable.value_float = value; return variable; }
+    static Variable of(char value) { Variable variable; variable.type = _char; variable.live = true; variable.value_char = value; return variable; }
+    static Variable of(std::string value) { Variable variable; variable.type = _string; variable.live = true; variable.value_string = value; return variable; }
+
+    bool holds(Type expected) const { return live && type == expected; }
+    int as_int() const { return type == _int ? value_int : 0; }
+    float as_float() const { return type == _float ? value_float : 0.0f; }
+    char as_char() const { return type == _char ? value_char : ' '; }
+    std::string as_string() const { return type == _string ? value_string : ""; }
+};
+)prelude";
+
+// Goes after the variables, everything the translated lines call into
+const char *const cpp_prelude_body = R"prelude(
+inline void pause(int milliseconds)
+{
+    std::this_thread::sleep_for((std::chrono::milliseconds)(int)(milliseconds * FRUSTRATION_MULTIPLIER));
+}
+
+inline void echo_input(bool on)
+{
+#ifndef _WIN32
+    static termios original;
+    static bool saved = false;
+    if (!saved)
+    {
+        tcgetattr(STDIN_FILENO, &original);
+        saved = true;
+    }
+    termios current = original;
+    if (on) current.c_lflag |= ECHO;
+    else current.c_lflag &= ~ECHO;
+    tcsetattr(STDIN_FILENO, TCSANOW, &current);
+#endif
+}
+
+inline void progress_city(float width, float time)
+{
+    std::cout << hide_cursor;
+    echo_input(false);
+    for (float i = 0; i <= 100.0f; i++)
+    {
+        std::cout << "[";
+        for (float j = 0; j < width; j++)
+        {
+            if (j < i / (100.0f / width)) std::cout << "#";
+            else std::cout << " ";
+        }
+        std::cout << "] " << i << "%\r" << std::flush;
+        pause((int)time * 10);
+    }
+    echo_input(true);
+    std::cout << show_cursor << '\n';
+}
+
+inline void diagnose(size_t line, std::string what)
+{
+    std::string message = "Line #" + std::to_string(line + 1) + " has witnessed a witch. Diagnosing...";
+    std::cout << message << '\n';
+    progress_city(message.size() - 7.0f, 2.0f);
+    std::cout << "Skill issue. ";
+    std::flush(std::cout);
+    pause(2000);
+    std::cout << what;
+    std::flush(std::cout);
+    pause(2000);
+    std::cout << "Eh... whatever I guess...\n";
+    pause(2000);
+}
+
+inline void declare(size_t line, size_t slot, const Variable &value)
+{
+    if (!v[slot].live) v[slot] = value;
+    else diagnose(line, "Variable " + red + names[slot] + reset + " already exists\n");
+}
+
+inline void scan(size_t line, size_t slot)
+{
+    Variable &var = v[slot];
+    if (!var.live)
+    {
+        diagnose(line, "Well how many freaking times do I have to tell you that variable " + red + names[slot] + reset + " does not exist for scanning?? What a jerk...\n");
+        return;
+    }
+    switch (var.type)
+    {
+        case Variable::_int:
+        {
+            int value = 0;
+            std::cin >> value;
+            var.value_int = value;
+            break;
+        }
+        case Variable::_float:
+        {
+            float value = 0;
+            std::cin >> value;
+            var.value_float = value;
+            break;
+        }
+        case Variable::_char:
+        {
+            char value = 0;
+            std::cin >> value;
+            var.value_char = value;
+            break;
+        }
+        case Variable::_string:
+            std::getline(std::cin, var.value_string);
+            break;
+    }
+}
+
+inline void print(size_t line, size_t slot)
+{
+    const Variable &var = v[slot];
+    if (!var.live)
+    {
+        diagnose(line, "Hell no I am not repeating this again... Variable " + red + names[slot] + reset + " does not exist for printing\n");
+        return;
+    }
+    switch (var.type)
+    {
+        case Variable::_int: std::cout << var.value_int; break;
+        case Variable::_float: std::cout << var.value_float; break;
+        case Variable::_char: std::cout << var.value_char; break;
+        case Variable::_string: std::cout << var.value_string; break;
+    }
+}
+
+inline void obliterate(size_t line, size_t slot)
+{
+    if (!v[slot].live) diagnose(line, "Damn... Variable " + std::string(names[slot]) + " does not exist for deletion\n");
+    else v[slot] = Variable {};
+}
+
+// Whether branch jumps, by the same odd rules per type
+inline bool branches(size_t line, size_t slot)
+{
+    const Variable &var = v[slot];
+    if (!var.live)
+    {
+        diagnose(line, "Oof... Variable " + std::string(names[slot]) + " does not exist for branching\n");
+        return false;
+    }
+    switch (var.type)
+    {
+        case Variable::_int: return var.as_int() != 0;
+        case Variable::_float: return var.as_int() != 0.0f;
+        case Variable::_char: return var.as_int() != ' ';
+        case Variable::_string: return var.as_string() != "";
+    }
+    return false;
+}
+
+// kind is '=' for copy, '!' for not, ' ' for nothing, '?' for wdym, otherwise the operator
+// false means the program gave up and has to stop
+inline bool assign(size_t line, char kind, size_t dest_slot, size_t left_slot, size_t right_slot)
+{
+    if (!v[dest_slot].live)
+    {
+        diagnose(line, "That's it. I am done. Variable " + red + bold + underline + names[dest_slot] + reset + " never existed (or is deleted now) but you decided to use it anyways. I am gone\n");
+        std::cout << "Quitting...\n";
+        progress_city(11 - 7.0f, 5.0f);
+        return false;
+    }
+    if (kind == '?')
+    {
+        diagnose(line, "Wdym by that??\n");
+        return true;
+    }
+    if (kind == ' ') return true;
+
+    auto Request = [&](size_t slot) -> bool {
+        if (!v[slot].live)
+        {
+            diagnose(line, "Variable... uff, " + red + names[slot] + reset + " does not exist... yey");
+            return false;
+        }
+        return true;
+    };
+
+    Variable &dest = v[dest_slot];
+    if (kind == '=')
+    {
+        if (!Request(left_slot)) return true;
+        const Variable &source = v[left_slot];
+        switch (dest.type)
+        {
+            case Variable::_int: dest.value_int = source.as_int(); break;
+            case Variable::_float: dest.value_float = source.as_float(); break;
+            case Variable::_char: dest.value_char = source.as_char(); break;
+            case Variable::_string: dest.value_string = source.as_string(); break;
+        }
+        return true;
+    }
+    if (kind == '!')
+    {
+        if (!Request(left_slot)) return true;
+        const Variable &source = v[left_slot];
+        switch (dest.type)
+        {
+            case Variable::_int: dest.value_int = !source.as_int(); break;
+            case Variable::_float: dest.value_float = !source.as_float(); break;
+            case Variable::_char: dest.value_char = !source.as_char(); break;
+            case Variable::_string: diagnose(line, "What do you mean by noting a string from another string??"); break;
+        }
+        return true;
+    }
+
+    if (!Request(left_slot) || !Request(right_slot)) return true;
+    const Variable &left = v[left_slot];
+    const Variable &right = v[right_slot];
+    switch (kind)
+    {
+        case '+':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() + right.as_int(); break;
+                case Variable::_float: dest.value_float = left.as_float() + right.as_float(); break;
+                case Variable::_char: dest.value_char = left.as_char() + right.as_char(); break;
+                case Variable::_string: dest.value_string = left.as_string() + right.as_string(); break;
+            }
+            break;
+        case '-':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() - right.as_int(); break;
+                case Variable::_float: dest.value_float = left.as_float() - right.as_float(); break;
+                case Variable::_char: dest.value_char = left.as_char() - right.as_char(); break;
+                case Variable::_string:
+                {
+                    std::string result = left.as_string();
+                    std::string remove = right.as_string();
+                    size_t pos = 0;
+                    while ((pos = result.find(remove, pos)) != std::string::npos)
+                    {
+                        result.erase(pos, remove.length());
+                    }
+                    dest.value_string = result;
+                    break;
+                }
+            }
+            break;
+        case '*':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() * right.as_int(); break;
+                case Variable::_float: dest.value_float = left.as_float() * right.as_float(); break;
+                case Variable::_char: dest.value_char = left.as_char() * right.as_char(); break;
+                case Variable::_string: diagnose(line, "What do you mean by multiplying a string from another string??"); break;
+            }
+            break;
+        case '/':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() / right.as_int(); break;
+                case Variable::_float: dest.value_float = left.as_float() / right.as_float(); break;
+                case Variable::_char: dest.value_char = left.as_char() / right.as_char(); break;
+                case Variable::_string: diagnose(line, "What do you mean by dividing a string from another string??"); break;
+            }
+            break;
+        case '%':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() % right.as_int(); break;
+                case Variable::_float: dest.value_float = std::fmod(left.as_float(), right.as_float()); break;
+                case Variable::_char: dest.value_char = left.as_char() % right.as_char(); break;
+                case Variable::_string: diagnose(line, "What do you mean by modulating a string from another string??"); break;
+            }
+            break;
+        case '^':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = std::pow(left.as_int(), right.as_int()); break;
+                case Variable::_float: dest.value_float = std::pow(left.as_float(), right.as_float()); break;
+                case Variable::_char: dest.value_char = std::pow(left.as_char(), right.as_char()); break;
+                case Variable::_string: diagnose(line, "What do you mean by exponentiating a string from another string??"); break;
+            }
+            break;
+        case '&':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() && right.as_int(); break;
+                case Variable::_float: dest.value_float = left.as_float() && right.as_float(); break;
+                case Variable::_char: dest.value_char = left.as_char() && right.as_char(); break;
+                case Variable::_string: diagnose(line, "What do you mean by anding a string from another string??"); break;
+            }
+            break;
+        case '|':
+            switch (dest.type)
+            {
+                case Variable::_int: dest.value_int = left.as_int() || right.as_int(); break;
+                case Variable::_float: dest.value_float = left.as_float() || right.as_float(); break;
+                case Variable::_char: dest.value_char = left.as_char() || right.as_char(); break;
+                case Variable::_string: diagnose(line, "What do you mean by oring a string from another string??"); break;
+            }
+            break;
+    }
+    return true;
+}
+
+// Locals of every frame, each call remembers where its own start
+static std::vector<std::pair<size_t, Variable>> locals;
+
+inline void make_local(size_t line, size_t slot, const std::vector<size_t> &marks)
+{
+    if (marks.empty())
+    {
+        diagnose(line, "Local to what?? Nobody called this, so " + red + names[slot] + reset + " is just a normal variable\n");
+        return;
+    }
+    for (size_t k = marks.back(); k < locals.size(); k++)
+    {
+        if (locals[k].first == slot) return;
+    }
+    locals.push_back({ slot, std::move(v[slot]) });
+    v[slot] = Variable();
+}
+
+inline void put_back_locals(size_t mark)
+{
+    while (locals.size() > mark)
+    {
+        v[locals.back().first] = std::move(locals.back().second);
+        locals.pop_back();
+    }
+}
+
+// What return said to give back (from is -1 if it said nothing) goes to the slot the call asked for
+inline void give_back(size_t line, size_t slot, size_t from, const Variable &value)
+{
+    if (from == (size_t)-1)
+    {
+        diagnose(line, "Whoever called this wanted " + red + names[slot] + reset + " back and you gave them nothing\n");
+        return;
+    }
+    if (!value.live)
+    {
+        diagnose(line, "Variable " + red + names[from] + reset + " does not exist, so I can't exactly give it back\n");
+        return;
+    }
+    Variable &dest = v[slot];
+    if (!dest.live)
+    {
+        dest = value;
+        return;
+    }
+    switch (dest.type)
+    {
+        case Variable::_int: dest.value_int = value.as_int(); break;
+        case Variable::_float: dest.value_float = value.as_float(); break;
+        case Variable::_char: dest.value_char = value.as_char(); break;
+        case Variable::_string: dest.value_string = value.as_string(); break;
+    }
+}
+)prelude";
+
+// Everything above can be had without the program itself, bench/micro.cpp does that
+#ifndef LASTSMALL_NO_MAIN
+int main(int argc, char **argv)
+{
+    output.install();
+
+    // --------------------------------
+    // Flags setup
+    // --------------------------------
+
+    enum class Flags {
+        help = 0,
+        debug,
+        jit,
+        emit_cpp,
+        opt_report,
+        max_depth,
+        batch,
+        no_cache,
+        trace,
+        decode_trace,
+        profile,
+        jobs
+    };
+    std::vector<argp::Flag> flags = {
+        argp::Flag { "Print this help message", { "help", "manual", "man" }, { 'h', 'm', '?' }, {}, 0 },
+        argp::Flag { "Show each line ran", { "debug" }, { 'd' }, {}, 0 },
+        argp::Flag { "Compile hot labels to machine code (x86-64 only)", { "jit" }, { 'j' }, {}, 0 },
+        argp::Flag { "Write each file as C++ (filename.cpp) instead of running it", { "emit-cpp" }, { 'E' }, {}, 0 },
+        argp::Flag { "Show what the optimizer took out of each file", { "opt-report" }, { 'O' }, {}, 0 },
+        argp::Flag { "How deep calls can nest before giving up on them", { "max-depth" }, { 'D' }, { "depth" }, 0 },
+        argp::Flag { "No waiting, no TTY games, diagnostics go to stderr as JSON lines", { "batch" }, { 'b' }, {}, 0 },
+        argp::Flag { "Compile every file from scratch, no reading or writing filename.lsmc", { "no-cache" }, { 'C' }, {}, 0 },
+        argp::Flag { "Record every instruction ran into a binary file, cheap enough to leave on", { "trace" }, { 't' }, { "file" }, 0 },
+        argp::Flag { "Print a --trace file like --debug would have, then leave", { "decode-trace" }, { 'T' }, { "file" }, 0 },
+        argp::Flag { "Count where the time goes by line, label and call stack, report in file and file.folded", { "profile" }, { 'p' }, { "file" }, 0 },
+        argp::Flag { "Run files side by side, each in its own interpreter with its own copy of stdin (count is every core if not given)", { "jobs" }, { 'J' }, { "count" }, 1 }
+    };
+
+    // --------------------------------
+    // Program variables
+    // --------------------------------
+
+    std::vector<std::string> filenames;
+    int debug = false;
+    int jit = false;
+    int emit_cpp = false;
+    int opt_report = false;
+    size_t max_depth = MAX_CALL_DEPTH;
+    int batch = false;
+    int cache = true;
+    std::string trace_path;
+    std::string decode_path;
+    std::string profile_path;
+    size_t jobs = 0; // 0 runs every file in this process one after another
+
+    // --------------------------------
+    // Command line flag handlers
+    // --------------------------------
+
+    auto Help = [&](const argp::Option &option) {
+        (void)option;
+        argp::print_help(flags, "Usage: Just use the program already... pass in the filename ok?\n       lastsmall filename.ls\nYou have some options tho:\n", "\nNo you don't report any bugs because I will never resolve them.\n");
+        std::exit(0);
+    };
+
+    auto Debug = [&](const argp::Option &option) {
+        (void)option;
+        debug = !debug;
+    };
+
+    auto Jit = [&](const argp::Option &option) {
+        (void)option;
+        if (!JIT_SUPPORTED)
+        {
+            std::cout << "Your machine doesn't deserve machine code. Interpreting like it's 1995\n";
+            return;
+        }
+        jit = !jit;
+    };
+
+    auto Emit = [&](const argp::Option &option) {
+        (void)option;
+        emit_cpp = !emit_cpp;
+    };
+
+    auto OptReport = [&](const argp::Option &option) {
+        (void)option;
+        opt_report = !opt_report;
+    };
+
+    auto MaxDepth = [&](const argp::Option &option) {
+        std::string depth = option.additional_arguments.empty() ? "" : option.additional_arguments[0];
+        if (depth.empty() || depth.find_first_not_of("0123456789") != std::string::npos || std::stoull(depth) == 0)
+        {
+            std::cout << "A call depth of " << red << (depth.empty() ? "nothing" : depth) << reset << "? Sure. I'll stick with " << max_depth << '\n';
+            return;
+        }
+        max_depth = std::stoull(depth);
+    };
+
+    auto Batch = [&](const argp::Option &option) {
+        (void)option;
+        batch = !batch;
+    };
+
+    auto NoCache = [&](const argp::Option &option) {
+        (void)option;
+        cache = !cache;
+    };
+
+    auto Trace = [&](const argp::Option &option) {
+        if (option.additional_arguments.empty())
+        {
+            std::cout << "Trace into " << red << "where" << reset << " exactly? Not tracing\n";
+            return;
+        }
+        trace_path = option.additional_arguments[0];
+    };
+
+    auto DecodeTracePath = [&](const argp::Option &option) {
+        if (option.additional_arguments.empty())
+        {
+            std::cout << "Decode " << red << "what" << reset << " exactly?\n";
+            return;
+        }
+        decode_path = option.additional_arguments[0];
+    };
+
+    auto Profile = [&](const argp::Option &option) {
+        if (option.additional_arguments.empty())
+        {
+            std::cout << "Profile into " << red << "where" << reset << " exactly? Not profiling\n";
+            return;
+        }
+        profile_path = option.additional_arguments[0];
+    };
+
+    auto Jobs = [&](const argp::Option &option) {
+#ifdef _WIN32
+        (void)option;
+        std::cout << "No fork() on this thing, files take turns like they always did\n";
+#else
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+        if (option.additional_arguments.empty()) return;
+        const std::string &count = option.additional_arguments[0];
+        if (count.empty() || count.find_first_not_of("0123456789") != std::string::npos)
+        {
+            filenames.push_back(count); // Not a count, just the first file
+            return;
+        }
+        if (count.size() > 6 || std::stoull(count) == 0)
+        {
+            std::cout << "A job count of " << red << count << reset << "? Sure. I'll stick with " << jobs << '\n';
+            return;
+        }
+        jobs = std::stoull(count);
+#endif
+    };
+
+    // --------------------------------
+    // Command line parsing
+    // --------------------------------
+
+    auto Pause = [](int milliseconds) {
+        std::this_thread::sleep_for((std::chrono::milliseconds)(int)(milliseconds * FRUSTRATION_MULTIPLIER));
+    };
+
+    auto ProgressCity = [Pause](float width, float time) {
+        std::cout << hide_cursor;
+        remove_tty_flag(ECHO);
+        for (float i = 0; i <= 100.0f; i++)
+        {
+            std::cout << "[";
+            for (float j = 0; j < width; j++)
+            {
+                if (j < i / (100.0f / width)) std::cout << "#";
+                else std::cout << " ";
+            }
+            std::cout << "] " << i << "%\r" << std::flush;
+            Pause((int)time * 10);
+        }
+        insert_tty_flag(ECHO);
+        std::cout << show_cursor << '\n';
+    };
+
+    std::vector<argp::Option> options = argp::get_options_from_flags(argc, argv, flags);
+    for (const argp::Option &option : options)
+    {
+        if (!option.unrecognized_option.empty())
+        {
+            if (option.unrecognized_option.substr(0, 2) == "--" || option.unrecognized_option.substr(0, 1) == "-" || option.unrecognized_option.substr(0, 1) == "/")
+            {
+                std::cout << "Idk what the heck are you talking about... What do you mean by " << red << option.unrecognized_option << reset << "??\n";
+            }
+            else
+            {
+                filenames.push_back(option.unrecognized_option);
+            }
+        }
+        if (option.flag == &flags[(int)Flags::help]) Help(option);
+        if (option.flag == &flags[(int)Flags::debug]) Debug(option);
+        if (option.flag == &flags[(int)Flags::jit]) Jit(option);
+        if (option.flag == &flags[(int)Flags::emit_cpp]) Emit(option);
+        if (option.flag == &flags[(int)Flags::opt_report]) OptReport(option);
+        if (option.flag == &flags[(int)Flags::max_depth]) MaxDepth(option);
+        if (option.flag == &flags[(int)Flags::batch]) Batch(option);
+        if (option.flag == &flags[(int)Flags::no_cache]) NoCache(option);
+        if (option.flag == &flags[(int)Flags::trace]) Trace(option);
+        if (option.flag == &flags[(int)Flags::decode_trace]) DecodeTracePath(option);
+        if (option.flag == &flags[(int)Flags::profile]) Profile(option);
+        if (option.flag == &flags[(int)Flags::jobs]) Jobs(option);
+    }
+
+    // Reading a trace back runs nothing, so it doesn't deserve the waiting either
+    if (!decode_path.empty())
+    {
+        if (DecodeTrace(decode_path)) return 0;
+        std::cout << red << decode_path << reset << " is not a trace I made. Or it is and you broke it\n";
+        return 1;
+    }
+
+#ifndef DEBUG
+    // Remove 5 seconds from their life expectancy every time they use this program (unless a robot is using it)
+    if (!batch)
+    {
+        std::string creepy_message = "You have to wait 5 seconds for the below pointless progress bar to finish counting";
+        std::cout << red << creepy_message << reset << '\n';
+        ProgressCity(creepy_message.size() - 7.0f, 5.0f);
+    }
+#endif
+
+    // --------------------------------
+    // Time wasting
+    // --------------------------------
+
+    std::srand(std::time(0));
+    if (RANDOM_CRASH && !batch && std::rand() % 10 == 0)
+    {
+        std::cout << red << "You're too unlucky! The pointless timer just randomly failed!! " << reset << "This happens 1/10th of the times. Quitting please don't stop me I shall end my life (process) right now\n";
+        std::cout << "Quitting...\n";
+        ProgressCity(11 - 7.0f, 5.0f);
+        return 0;
+    }
+
+    // Yeah we remind user if they forgot something, after they have ruined 5 seconds of their life
+    if (filenames.empty())
+    {
+        std::cout << red << "You literally forgot the main thing... really??\n";
+    }
+
+    // --------------------------------
+    // Actual program stuff
+    // --------------------------------
+
+    SymbolTable symbols;
+    std::vector<Variable> variables; // Indexed by slot
+
+    CallStack goneto_stack(max_depth);
+    Variable returned; // What return is giving back while the parameters are put back
+
+    Debugger yesbug;
+
+    // What kind of witch a line has witnessed, --batch counts each kind
+    enum class Witch {
+        already_exists = 0,
+        no_label,
+        no_variable,
+        too_deep,
+        nowhere_to_go_back,
+        nothing_given_back,
+        not_called,
+        too_many_locals,
+        gone_for_good,
+        wdym,
+        string_math,
+        lost_local,
+        nothing_after_arrow,
+        too_many_parameters,
+        label_remade,
+        too_many_arguments,
+        bad_number,
+        missing_file, // Not on any line, the whole file isn't there
+        count
+    };
+    const char *const witch_names[] = {
+        "already_exists", "no_label", "no_variable", "too_deep", "nowhere_to_go_back", "nothing_given_back", "not_called", "too_many_locals",
+        "gone_for_good", "wdym", "string_math", "lost_local", "nothing_after_arrow", "too_many_parameters", "label_remade", "too_many_arguments", "bad_number",
+        "missing_file"
+    };
+    static_assert(sizeof(witch_names) / sizeof(*witch_names) == (size_t)Witch::count, "Every witch needs a name");
+
+    std::string running_file; // Whose lines the witches are on
+    auto running_since = std::chrono::steady_clock::now();
+    std::array<size_t, (size_t)Witch::count> witch_counts = {};
+
+    // Colors and the newline are for humans, everything else gets escaped
+    auto Json = [](std::string_view text) -> std::string {
+        std::string quoted = "\"";
+        for (size_t k = 0; k < text.size(); k++)
+        {
+            char c = text[k];
+            if (c == '\033')
+            {
+                while (k < text.size() && !std::isalpha((unsigned char)text[k])) k++;
+                continue;
+            }
+            if (c == '\n' && k + 1 == text.size()) break;
+            if (c == '"' || c == '\\') quoted += std::string("\\") + c;
+            else if (c == '\n') quoted += "\\n";
+            else if (c == '\t') quoted += "\\t";
+            else if ((unsigned char)c < ' ' || c == 127)
+            {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+                quoted += escaped;
+            }
+            else quoted += c;
+        }
+        return quoted + "\"";
+    };
+
+    // line is -1 for witches that aren't on any line
+    auto Diagnose = [&](size_t line, Witch kind, std::string_view name, std::string what) {
+        witch_counts[(size_t)kind]++;
+        if (batch)
+        {
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - running_since).count();
+            std::cerr << "{\"file\":" << Json(running_file) << ",\"line\":" << (line == (size_t)-1 ? "null" : std::to_string(line + 1)) << ",\"kind\":\"" << witch_names[(size_t)kind] << "\",\"variable\":" << (name.empty() ? "null" : Json(name)) << ",\"message\":" << Json(what) << ",\"us\":" << us << "}\n";
+            return;
+        }
+        if (line == (size_t)-1)
+        {
+            std::cout << what;
+            return;
+        }
+        std::string message = "Line #" + std::to_string(line + 1) + " has witnessed a witch. Diagnosing...";
+        std::cout << message << '\n';
+        ProgressCity(message.size() - 7.0f, 2.0f);
+        std::cout << "Skill issue. ";
+        std::flush(std::cout);
+        Pause(2000);
+        std::cout << what;
+        std::flush(std::cout);
+        Pause(2000);
+        std::cout << "Eh... whatever I guess...\n";
+        Pause(2000);
+    };
+
+    // return hands its value to the slot the call asked for, converted like any assignment if that already exists
+    auto GiveBack = [&](size_t slot) {
+        Variable &dest = variables[slot];
+        if (!dest.live)
+        {
+            dest = std::move(returned);
+            return;
+        }
+        switch (dest.type)
+        {
+            case Variable::_int:
+                dest.value_int = returned.as_int();
+                break;
+            case Variable::_float:
+                dest.value_float = returned.as_float();
+                break;
+            case Variable::_char:
+                dest.value_char = returned.as_char();
+                break;
+            case Variable::_string:
+                dest.set_string(returned.as_string());
+                break;
+        }
+    };
+
+    // jmp continues from the first instruction after that line
+    auto JmpTarget = [&](const std::vector<Instruction> &instructions, std::string_view text) -> size_t {
+        size_t line = ToInt(text);
+        auto after = std::partition_point(instructions.begin(), instructions.end() - 1, [&](const Instruction &other) {
+            return other.line <= line;
+        });
+        return (after - instructions.begin()) - 1;
+    };
+
+    // Tokenize every line once and decode it to an instruction
+    auto Compile = [&](const std::vector<std::string_view> &lines) -> Program {
+        Program program;
+        Tokenizer tokenizer;
+        std::vector<std::string_view> tokens;
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            tokenizer.split(lines[i]);
+            tokens.clear();
+            for (const Tokenizer::Token &token : tokenizer.tokens) tokens.push_back(tokenizer.text(token));
+            for (auto t : tokens) yesbug << "[" << t << "]\n";
+            if (tokens.empty())
+            {
+                continue;
+            }
+
+            // Missing tokens read as empty instead of running off the end of the line, Missing below says when one was needed
+            size_t token_count = tokens.size();
+            if (tokens.size() < 5) tokens.resize(5);
+
+            // Names become slots right here, operands are indices of tokens
+            auto Decode = [&](Opcode opcode, std::initializer_list<size_t> operands, std::string_view text = "", char operation = 0) -> Instruction {
+                Instruction instruction = { .opcode = opcode, .text = std::string(text), .operation = operation, .line = i };
+                size_t k = 0;
+                for (size_t token : operands) instruction.operands[k++] = symbols.intern(tokens[token]);
+                return instruction;
+            };
+
+            auto Complain = [&](Witch kind, std::string_view name, const std::string &what) {
+                Diagnose(i, kind, name, what);
+                program.complaints.push_back({ i, what });
+            };
+
+            // A line without everything it needs gets a complaint and is skipped, not a variable with no name
+            auto Missing = [&](size_t needed) {
+                if (token_count >= needed) return false;
+                Complain(Witch::wdym, tokens[0], "Wdym by that?? Something is missing after " + red + std::string(tokens[token_count - 1]) + reset + ", so I will just ignore the whole line\n");
+                return true;
+            };
+
+            // The initializer is a variable if one by that name exists when the line runs, otherwise this constant read off it right now
+            auto Declaration = [&](Opcode opcode) -> Instruction {
+                if (tokens[2] != "=") return Decode(opcode, { 1 });
+                Instruction instruction = Decode(opcode, { 1, 3 }, tokens[3]);
+                std::string_view text = tokens[3];
+                bool clean = true;
+                switch (opcode)
+                {
+                    case Opcode::declare_int: instruction.constant = Variable(ToInt(text, &clean)); break;
+                    case Opcode::declare_float: instruction.constant = Variable(ToFloat(text, &clean)); break;
+                    case Opcode::declare_char: instruction.constant = Variable(ToChar(text)); break;
+                    default: break;
+                }
+                // Names don't start with digits, so anything that does had better be all number
+                bool numeric = !text.empty() && (std::isdigit((unsigned char)text[0]) || (text[0] == '.' && opcode == Opcode::declare_float));
+                if (numeric && !clean)
+                {
+                    std::string value = opcode == Opcode::declare_int ? std::to_string(instruction.constant.value_int) : std::to_string(instruction.constant.value_float);
+                    Complain(Witch::bad_number, tokens[1], "What kind of number is " + red + std::string(text) + reset + "?? I read it as " + value + " and moved on\n");
+                }
+                return instruction;
+            };
+
+            Instruction instruction;
+            const Keyword *keyword = find_keyword(tokens[0]);
+
+            // local int x = 5 is a make_local for x, then the declaration like always
+            if (keyword && keyword->opcode == Opcode::make_local)
+            {
+                const Keyword *declaration = find_keyword(tokens[1]);
+                if (declaration && declaration->opcode >= Opcode::declare_int && declaration->opcode <= Opcode::declare_string)
+                {
+                    // Without a name the declaration below complains about it
+                    if (token_count > 2) program.instructions.push_back(Decode(Opcode::make_local, { 2 }));
+                }
+                else
+                {
+                    Complain(Witch::lost_local, tokens[0], "Local what?? " + red + std::string(tokens[0]) + reset + " goes right before int, float, char or string. I will just ignore it\n");
+                }
+                tokens.erase(tokens.begin());
+                tokens.resize(std::max<size_t>(tokens.size(), 5));
+                if (--token_count == 0) continue;
+                keyword = find_keyword(tokens[0]);
+            }
+
+            if (keyword)
+            {
+                switch (keyword->opcode)
+                {
+                    case Opcode::declare_int:
+                    case Opcode::declare_float:
+                    case Opcode::declare_char:
+                    case Opcode::declare_string:
+                        if (Missing(tokens[2] == "=" ? 4 : 2)) continue;
+                        instruction = Declaration(keyword->opcode);
+                        break;
+                    case Opcode::call:
+                    {
+                        // call label [arguments...] [-> result], the tokenizer splits -> in two
+                        if (Missing(2)) continue;
+                        instruction = Decode(keyword->opcode, {}, tokens[1]);
+                        size_t k = 2;
+                        for (; k < token_count && !(tokens[k] == "-" && k + 1 < token_count && tokens[k + 1] == ">"); k++)
+                        {
+                            instruction.arguments.push_back(symbols.intern(tokens[k]));
+                        }
+                        if (k + 2 < token_count) instruction.operands[0] = symbols.intern(tokens[k + 2]);
+                        else if (k < token_count) Complain(Witch::nothing_after_arrow, "", "Give it back to what?? There is nothing after the " + red + "->" + reset + ", so I will just throw it away\n");
+                        break;
+                    }
+                    case Opcode::go_to:
+                    case Opcode::jmp:
+                        if (Missing(2)) continue;
+                        instruction = Decode(keyword->opcode, {}, tokens[1]);
+                        break;
+                    case Opcode::go_back:
+                        if (token_count > 1) instruction = Decode(keyword->opcode, { 1 });
+                        else instruction = Decode(keyword->opcode, {});
+                        break;
+                    case Opcode::scan:
+                    case Opcode::print:
+                    case Opcode::obliterate:
+                        if (Missing(2)) continue;
+                        instruction = Decode(keyword->opcode, { 1 });
+                        break;
+                    case Opcode::branch:
+                    case Opcode::exists:
+                        if (Missing(3)) continue;
+                        instruction = Decode(keyword->opcode, { 1 }, tokens[2]);
+                        break;
+                    default:
+                        instruction = Decode(keyword->opcode, {});
+                        break;
+                }
+            }
+            else if (tokens[1] == ":")
+            {
+                // Whatever comes after the colon is what the label takes
+                instruction = Decode(Opcode::label, {}, tokens[0]);
+                for (size_t k = 2; k < token_count; k++) instruction.arguments.push_back(symbols.intern(tokens[k]));
+                if (instruction.arguments.size() > MAX_CALL_ARGUMENTS)
+                {
+                    Complain(Witch::too_many_parameters, instruction.text, "Label " + red + instruction.text + reset + " takes " + std::to_string(instruction.arguments.size()) + " things, nobody can remember more than " + std::to_string(MAX_CALL_ARGUMENTS) + ". The rest are just gone\n");
+                    instruction.arguments.resize(MAX_CALL_ARGUMENTS);
+                }
+            }
+            else if (tokens[1] != "=")
+            {
+                instruction = Decode(Opcode::assign_wdym, { 0 });
+            }
+            else if (token_count == 3)
+            {
+                instruction = Decode(Opcode::assign_copy, { 0, 2 });
+            }
+            else if (tokens[2] == "!")
+            {
+                instruction = Decode(Opcode::assign_not, { 0, 3 });
+            }
+            else if (tokens[3].size() == 1 && std::string_view("+-*/%^&|").find(tokens[3][0]) != std::string_view::npos)
+            {
+                if (Missing(5)) continue;
+                instruction = Decode(Opcode::assign_binary, { 0, 2, 4 }, "", tokens[3][0]);
+            }
+            else
+            {
+                instruction = Decode(Opcode::assign_nothing, { 0 });
+            }
+            if (instruction.opcode == Opcode::label)
+            {
+                auto [existing, inserted] = program.labels.try_emplace(instruction.text, program.instructions.size());
+                if (!inserted)
+                {
+                    // Keep the old "last one wins" behavior but at least tell them about it
+                    Complain(Witch::label_remade, instruction.text, "Label " + red + instruction.text + reset + " was already made on line #" + std::to_string(program.instructions[existing->second].line + 1) + "... I will just pretend that one never existed\n");
+                    existing->second = program.instructions.size();
+                }
+            }
+            program.instructions.push_back(instruction);
+        }
+        program.instructions.push_back(Instruction { .opcode = Opcode::finish, .line = lines.size() });
+
+        // Types each name is declared as in this file, one bit per Variable::Type
+        std::vector<unsigned char> declared_types(symbols.names.size());
+        for (const Instruction &instruction : program.instructions)
+        {
+            if (instruction.opcode >= Opcode::declare_int && instruction.opcode <= Opcode::declare_string)
+            {
+                declared_types[instruction.operands[0]] |= 1 << ((int)instruction.opcode - (int)Opcode::declare_int);
+            }
+        }
+
+        // Arithmetic where every operand can only ever be one type skips the type switches
+        // It still checks at runtime (a variable could be left over from an earlier file) and falls back to assign_binary
+        for (Instruction &instruction : program.instructions)
+        {
+            if (instruction.opcode != Opcode::assign_binary) continue;
+            unsigned char types = declared_types[instruction.operands[0]];
+            if (types != declared_types[instruction.operands[1]] || types != declared_types[instruction.operands[2]]) continue;
+            if (types == 1 << Variable::_int)
+            {
+                switch (instruction.operation)
+                {
+                    case '+': instruction.opcode = Opcode::add_int; break;
+                    case '-': instruction.opcode = Opcode::sub_int; break;
+                    case '*': instruction.opcode = Opcode::mul_int; break;
+                    case '/': instruction.opcode = Opcode::div_int; break;
+                    case '%': instruction.opcode = Opcode::mod_int; break;
+                }
+            }
+            else if (types == 1 << Variable::_float)
+            {
+                switch (instruction.operation)
+                {
+                    case '+': instruction.opcode = Opcode::add_float; break;
+                    case '-': instruction.opcode = Opcode::sub_float; break;
+                    case '*': instruction.opcode = Opcode::mul_float; break;
+                    case '/': instruction.opcode = Opcode::div_float; break;
+                }
+            }
+            else if (types == 1 << Variable::_string && instruction.operation == '+')
+            {
+                instruction.opcode = Opcode::concat_string;
+            }
+        }
+
+        // Resolve every jump now so running one is just an assignment
+        for (Instruction &instruction : program.instructions)
+        {
+            switch (instruction.opcode)
+            {
+                case Opcode::call:
+                case Opcode::go_to:
+                case Opcode::branch:
+                case Opcode::exists:
+                {
+                    auto found = program.labels.find(instruction.text);
+                    if (found != program.labels.end()) instruction.target = found->second;
+                    // Arguments nobody takes have nowhere to go
+                    size_t takes = found != program.labels.end() ? program.instructions[found->second].arguments.size() : 0;
+                    if (instruction.opcode == Opcode::call && instruction.arguments.size() > takes)
+                    {
+                        std::string what = "Label " + red + instruction.text + reset + " only takes " + std::to_string(takes) + " things and you are giving it " + std::to_string(instruction.arguments.size()) + ". Keep the rest\n";
+                        Diagnose(instruction.line, Witch::too_many_arguments, instruction.text, what);
+                        program.complaints.push_back({ instruction.line, what });
+                        instruction.arguments.resize(takes);
+                    }
+                    break;
+                }
+                case Opcode::jmp:
+                    instruction.target = JmpTarget(program.instructions, instruction.text);
+                    break;
+                default:
+                    break;
+            }
+        }
+        // Slots for names that showed up just now
+        variables.resize(symbols.names.size());
+        return program;
+    };
+
+    // Hash of what Compile gets to see, the cache is only good for exactly these lines
+    auto SourceHash = [](const std::vector<std::string_view> &lines) -> uint64_t {
+        uint64_t hash = Fnv(nullptr, 0);
+        for (std::string_view line : lines)
+        {
+            hash = Fnv(line.data(), line.size(), hash);
+            hash = Fnv("\n", 1, hash);
+        }
+        return hash;
+    };
+
+    // Files that complained while compiling aren't cached, the complaints would have to be said again anyway
+    auto SaveCache = [&](const std::string &filename, const std::vector<std::string_view> &lines, const Program &program) {
+        if (!program.complaints.empty()) return;
+        std::vector<CachedInstruction> instructions;
+        std::vector<CachedLabel> labels;
+        std::vector<CachedString> names;
+        std::vector<uint64_t> slots;
+        std::vector<char> chars;
+
+        auto String = [&](std::string_view text) -> CachedString {
+            CachedString cached = { chars.size(), text.size() };
+            chars.insert(chars.end(), text.begin(), text.end());
+            return cached;
+        };
+
+        // Only the names this file uses, in the order they got their slots
+        std::vector<size_t> used;
+        for (const Instruction &instruction : program.instructions)
+        {
+            for (size_t operand : instruction.operands)
+            {
+                if (operand != (size_t)-1) used.push_back(operand);
+            }
+            used.insert(used.end(), instruction.arguments.begin(), instruction.arguments.end());
+        }
+        std::sort(used.begin(), used.end());
+        used.erase(std::unique(used.begin(), used.end()), used.end());
+        auto Local = [&](size_t slot) -> uint64_t {
+            if (slot == (size_t)-1) return (uint64_t)-1;
+            return std::lower_bound(used.begin(), used.end(), slot) - used.begin();
+        };
+        for (size_t slot : used) names.push_back(String(symbols.names[slot]));
+
+        for (const Instruction &instruction : program.instructions)
+        {
+            CachedInstruction cached = {};
+            for (size_t k = 0; k < 3; k++) cached.operands[k] = Local(instruction.operands[k]);
+            cached.line = instruction.line;
+            cached.target = instruction.target == (size_t)-1 ? (uint64_t)-1 : instruction.target;
+            cached.text = String(instruction.text);
+            cached.arguments_offset = slots.size();
+            cached.arguments_count = instruction.arguments.size();
+            for (size_t argument : instruction.arguments) slots.push_back(Local(argument));
+            cached.constant_string = String(instruction.constant.as_string());
+            if (instruction.constant.type != Variable::_string) std::memcpy(&cached.constant_value, &instruction.constant.value_int, sizeof(cached.constant_value));
+            cached.opcode = (uint8_t)instruction.opcode;
+            cached.operation = instruction.operation;
+            cached.constant_type = instruction.constant.type;
+            cached.constant_live = instruction.constant.live;
+            instructions.push_back(cached);
+        }
+        for (const auto &[name, index] : program.labels) labels.push_back({ String(name), index });
+
+        std::vector<std::byte> payload[] = {
+            aplib::rawfile::to_bytes(instructions),
+            aplib::rawfile::to_bytes(labels),
+            aplib::rawfile::to_bytes(names),
+            aplib::rawfile::to_bytes(slots),
+            aplib::rawfile::to_bytes(chars)
+        };
+        CacheHeader header = {};
+        std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+        header.version = cache_version;
+        header.opcodes = (uint32_t)Opcode::finish + 1;
+        header.instruction_size = sizeof(CachedInstruction);
+        header.max_arguments = MAX_CALL_ARGUMENTS;
+        header.source_hash = SourceHash(lines);
+        header.source_lines = lines.size();
+        header.instructions = instructions.size();
+        header.labels = labels.size();
+        header.names = names.size();
+        header.slots = slots.size();
+        header.chars = chars.size();
+        header.payload_hash = Fnv(nullptr, 0);
+        for (const std::vector<std::byte> &bytes : payload) header.payload_hash = Fnv(bytes.data(), bytes.size(), header.payload_hash);
+
+        // Written next to the real one and renamed over, so nobody ever reads half a cache
+        std::string temporary = filename + "c.tmp";
+        aplib::rawfile::orfile ofile(temporary);
+        if (ofile.fail()) return; // Can't write there, no cache then
+        ofile.write(aplib::rawfile::to_bytes(header));
+        for (const std::vector<std::byte> &bytes : payload) ofile.write(bytes);
+        bool failed = ofile.fail();
+        ofile.close();
+        if (failed || std::rename(temporary.c_str(), (filename + "c").c_str()) != 0) std::remove(temporary.c_str());
+    };
+
+    // The program exactly like Compile would have made it, or nothing if the cache is missing, stale or mangled
+    auto LoadCache = [&](const std::string &filename, const std::vector<std::string_view> &lines) -> std::optional<Program> {
+        aplib::rawfile::irfile ifile(filename + "c");
+        if (ifile.fail()) return std::nullopt;
+        std::vector<std::byte> bytes;
+        ifile.read(bytes);
+        if (ifile.fail() || bytes.size() != sizeof(CacheHeader)) return std::nullopt;
+        CacheHeader header = aplib::rawfile::to_data<CacheHeader>(bytes);
+        if (std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.version != cache_version) return std::nullopt;
+        if (header.opcodes != (uint32_t)Opcode::finish + 1 || header.instruction_size != sizeof(CachedInstruction) || header.max_arguments != MAX_CALL_ARGUMENTS) return std::nullopt;
+        if (header.source_lines != lines.size() || header.source_hash != SourceHash(lines)) return std::nullopt;
+
+        std::vector<std::byte> payload[5];
+        uint64_t payload_hash = Fnv(nullptr, 0);
+        for (std::vector<std::byte> &blob : payload)
+        {
+            ifile.read(blob);
+            if (ifile.fail()) return std::nullopt;
+            payload_hash = Fnv(blob.data(), blob.size(), payload_hash);
+        }
+        if (payload_hash != header.payload_hash) return std::nullopt;
+        if (payload[0].size() != header.instructions * sizeof(CachedInstruction) || payload[1].size() != header.labels * sizeof(CachedLabel) || payload[2].size() != header.names * sizeof(CachedString) || payload[3].size() != header.slots * sizeof(uint64_t) || payload[4].size() != header.chars) return std::nullopt;
+        std::vector<CachedInstruction> instructions = aplib::rawfile::to_vector<CachedInstruction>(payload[0]);
+        std::vector<CachedLabel> labels = aplib::rawfile::to_vector<CachedLabel>(payload[1]);
+        std::vector<CachedString> names = aplib::rawfile::to_vector<CachedString>(payload[2]);
+        std::vector<uint64_t> slots = aplib::rawfile::to_vector<uint64_t>(payload[3]);
+        std::string_view chars((const char *)payload[4].data(), payload[4].size());
+
+        // Hash says it's ours, but still don't trust an offset to stay in bounds
+        auto Fits = [](uint64_t offset, uint64_t size, uint64_t total) { return offset <= total && size <= total - offset; };
+        auto Text = [&](const CachedString &cached) { return chars.substr(cached.offset, cached.size); };
+        bool sane = !instructions.empty() && instructions.back().opcode == (uint8_t)Opcode::finish;
+        for (const CachedString &name : names) sane = sane && Fits(name.offset, name.size, chars.size());
+        for (uint64_t slot : slots) sane = sane && slot < names.size();
+        for (const CachedLabel &label : labels) sane = sane && Fits(label.name.offset, label.name.size, chars.size()) && label.index < instructions.size();
+        for (const CachedInstruction &cached : instructions)
+        {
+            sane = sane && cached.opcode <= (uint8_t)Opcode::finish && cached.constant_type <= Variable::_string;
+            for (uint64_t operand : cached.operands) sane = sane && (operand == (uint64_t)-1 || operand < names.size());
+            sane = sane && (cached.target == (uint64_t)-1 || cached.target < instructions.size());
+            sane = sane && Fits(cached.text.offset, cached.text.size, chars.size()) && Fits(cached.constant_string.offset, cached.constant_string.size, chars.size());
+            sane = sane && Fits(cached.arguments_offset, cached.arguments_count, slots.size());
+        }
+        if (!sane) return std::nullopt;
+
+        // Cached slots to real ones, the same as a fresh compile when the names come in the same order
+        std::vector<size_t> remap(names.size());
+        for (size_t k = 0; k < names.size(); k++) remap[k] = symbols.intern(std::string(Text(names[k])));
+        auto Slot = [&](uint64_t cached) -> size_t { return cached == (uint64_t)-1 ? (size_t)-1 : remap[cached]; };
+
+        Program program;
+        program.instructions.reserve(instructions.size());
+        for (const CachedInstruction &cached : instructions)
+        {
+            Instruction instruction = { .opcode = (Opcode)cached.opcode, .text = std::string(Text(cached.text)), .operation = cached.operation, .line = cached.line, .arguments = {} };
+            for (size_t k = 0; k < 3; k++) instruction.operands[k] = Slot(cached.operands[k]);
+            instruction.target = cached.target == (uint64_t)-1 ? (size_t)-1 : cached.target;
+            for (uint64_t k = 0; k < cached.arguments_count; k++) instruction.arguments.push_back(Slot(slots[cached.arguments_offset + k]));
+            switch (cached.constant_type)
+            {
+                case Variable::_int: std::memcpy(&instruction.constant.value_int, &cached.constant_value, sizeof(int)); break;
+                case Variable::_float: std::memcpy(&instruction.constant.value_float, &cached.constant_value, sizeof(float)); break;
+                case Variable::_char: std::memcpy(&instruction.constant.value_char, &cached.constant_value, sizeof(char)); break;
+                case Variable::_string: instruction.constant.set_string(Text(cached.constant_string)); break;
+            }
+            instruction.constant.type = (Variable::Type)cached.constant_type;
+            instruction.constant.live = cached.constant_live;
+            program.instructions.push_back(std::move(instruction));
+        }
+        for (const CachedLabel &label : labels) program.labels.emplace(std::string(Text(label.name)), label.index);
+        variables.resize(symbols.names.size());
+        return program;
+    };
+
+    // --------------------------------
+    // Optimizer
+    // --------------------------------
+
+    enum class Pass {
+        threading,
+        folding,
+        propagation,
+        dead_stores,
+        unreachable,
+        count
+    };
+    const char *const pass_names[] = { "jump threading", "constant folding", "copy propagation", "dead-store elimination", "unreachable code" };
+
+    // What the optimizer did to one file, for --opt-report
+    struct OptimizerReport {
+        size_t before = 0;
+        size_t after = 0;
+        size_t removed[(size_t)Pass::count] = {};
+        size_t rewritten[(size_t)Pass::count] = {}; // Jumps rethreaded, instructions folded, operands propagated
+        std::string skipped;                        // Why nothing ran, empty if it did
+    };
+
+    // What the optimizer can prove about a slot at one point, anything it can't is unknown
+    struct Fact {
+        enum State : unsigned char {
+            unknown,
+            dead,
+            live
+        };
+        State state = unknown;
+        bool typed = false;    // Type is known (live slots only)
+        bool constant = false; // Value is known too (typed slots that aren't strings only)
+        Variable::Type type = Variable::_int;
+        int32_t bits = 0; // The value, floats and chars squeezed in
+
+        bool operator==(const Fact &other) const = default;
+    };
+
+    // Facts for every slot where a block starts, plus which slots are copies of which
+    struct FlowState {
+        std::vector<Fact> facts;
+        std::vector<std::pair<size_t, size_t>> copies; // (copy, original) holding the same value right now
+        bool reached = false;
+    };
+
+    auto Optimize = [&](Program &compiled) -> OptimizerReport {
+        std::vector<Instruction> &program = compiled.instructions;
+        const size_t none = (size_t)-1;
+        OptimizerReport report;
+        report.before = program.size();
+
+        // Slots that calls and returns write behind everyone's back, parameters, results and locals
+        std::vector<size_t> handed;
+        for (const Instruction &instruction : program)
+        {
+            if (instruction.opcode == Opcode::label) handed.insert(handed.end(), instruction.arguments.begin(), instruction.arguments.end());
+            if (instruction.opcode == Opcode::call && instruction.operands[0] != none) handed.push_back(instruction.operands[0]);
+            if (instruction.opcode == Opcode::make_local) handed.push_back(instruction.operands[0]);
+        }
+        std::sort(handed.begin(), handed.end());
+        handed.erase(std::unique(handed.begin(), handed.end()), handed.end());
+
+        // Flow analysis keeps a fact per slot per block, past this it costs more than it saves
+        // Checked with instructions instead of blocks, so a program too big to bother with doesn't even get its blocks found
+        constexpr size_t max_flow_cells = (size_t)1 << 22;
+
+        auto Jumps = [](Opcode opcode) {
+            return opcode == Opcode::call || opcode == Opcode::go_to || opcode == Opcode::branch || opcode == Opcode::exists;
+        };
+        // Everything that assigns into operands[0], in the order of Opcode
+        auto Assigns = [](Opcode opcode) {
+            return opcode >= Opcode::assign_copy && opcode <= Opcode::assign_constant;
+        };
+
+        // Drops marked instructions, jump targets are never marked so they only get renumbered
+        auto Compact = [&](const std::vector<bool> &removed) -> size_t {
+            std::vector<size_t> renumber(program.size(), none);
+            std::vector<Instruction> kept;
+            for (size_t k = 0; k < program.size(); k++)
+            {
+                if (removed[k]) continue;
+                renumber[k] = kept.size();
+                kept.push_back(std::move(program[k]));
+            }
+            size_t count = program.size() - kept.size();
+            program = std::move(kept);
+            for (Instruction &instruction : program)
+            {
+                if (Jumps(instruction.opcode) && instruction.target != none) instruction.target = renumber[instruction.target];
+                if (instruction.opcode == Opcode::jmp) instruction.target = JmpTarget(program, instruction.text);
+            }
+            for (auto label = compiled.labels.begin(); label != compiled.labels.end();)
+            {
+                if (renumber[label->second] == none) label = compiled.labels.erase(label);
+                else (label++)->second = renumber[label->second];
+            }
+            return count;
+        };
+
+        auto CallSites = [&]() {
+            std::vector<size_t> sites;
+            for (size_t k = 0; k < program.size(); k++)
+            {
+                if (program[k].opcode == Opcode::call && program[k].target != none) sites.push_back(k);
+            }
+            return sites;
+        };
+
+        // Where running instruction k can continue, return goes to none: one return node that goes on after every call
+        // Listing every call site for every return instead made big programs quadratic
+        auto Successors = [&](size_t k, std::vector<size_t> &next) {
+            next.clear();
+            const Instruction &instruction = program[k];
+            switch (instruction.opcode)
+            {
+                case Opcode::call:
+                    next.push_back(k + 1); // The stack was full
+                    if (instruction.target != none) next.push_back(instruction.target + 1);
+                    break;
+                case Opcode::go_to:
+                    next.push_back(instruction.target != none ? instruction.target + 1 : k + 1);
+                    break;
+                case Opcode::jmp:
+                    next.push_back(instruction.target + 1);
+                    break;
+                case Opcode::branch:
+                case Opcode::exists:
+                    next.push_back(k + 1);
+                    if (instruction.target != none) next.push_back(instruction.target + 1);
+                    break;
+                case Opcode::go_back:
+                    next.push_back(k + 1); // Nothing to go back to
+                    next.push_back(none);
+                    break;
+                case Opcode::escape:
+                case Opcode::finish:
+                    break;
+                default:
+                    next.push_back(k + 1);
+                    break;
+            }
+        };
+
+        // A value of that type, so folding asks the same as_int/as_float/as_char questions the interpreter does
+        auto Materialize = [](Variable::Type type, int32_t bits) -> Variable {
+            switch (type)
+            {
+                case Variable::_int: return Variable((int)bits);
+                case Variable::_float: return Variable(std::bit_cast<float>(bits));
+                case Variable::_char: return Variable((char)bits);
+                default: return Variable(std::string_view());
+            }
+        };
+        auto As = [](Variable::Type type, const Variable &value) -> int32_t {
+            switch (type)
+            {
+                case Variable::_int: return value.as_int();
+                case Variable::_float: return std::bit_cast<int32_t>(value.as_float());
+                default: return value.as_char();
+            }
+        };
+
+        // Same math as the generic assign, false for anything that would trap or that isn't worth it
+        auto Evaluate = [](char operation, Variable::Type type, const Variable &left, const Variable &right, int32_t &bits) -> bool {
+            if (type == Variable::_int)
+            {
+                int32_t a = left.as_int(), b = right.as_int();
+                switch (operation)
+                {
+                    case '+': bits = (int32_t)((uint32_t)a + (uint32_t)b); return true;
+                    case '-': bits = (int32_t)((uint32_t)a - (uint32_t)b); return true;
+                    case '*': bits = (int32_t)((uint32_t)a * (uint32_t)b); return true;
+                    case '/':
+                    case '%':
+                        if (b == 0 || (a == INT32_MIN && b == -1)) return false;
+                        bits = operation == '/' ? a / b : a % b;
+                        return true;
+                }
+            }
+            else if (type == Variable::_float)
+            {
+                float a = left.as_float(), b = right.as_float(), result;
+                switch (operation)
+                {
+                    case '+': result = a + b; break;
+                    case '-': result = a - b; break;
+                    case '*': result = a * b; break;
+                    case '/': result = a / b; break;
+                    case '%': result = std::fmod(a, b); break;
+                    default: return false;
+                }
+                bits = std::bit_cast<int32_t>(result);
+                return true;
+            }
+            else if (type == Variable::_char)
+            {
+                char a = left.as_char(), b = right.as_char();
+                switch (operation)
+                {
+                    case '+': bits = (char)(a + b); return true;
+                    case '-': bits = (char)(a - b); return true;
+                    case '*': bits = (char)(a * b); return true;
+                    case '/':
+                    case '%':
+                        if (b == 0) return false;
+                        bits = (char)(operation == '/' ? a / b : a % b);
+                        return true;
+                }
+            }
+            return false;
+        };
+
+        // The value an assignment always stores, if the facts before it pin it down
+        auto Compute = [&](const std::vector<Fact> &facts, const Instruction &instruction, int32_t &bits) -> bool {
+            const Fact &dest = facts[instruction.operands[0]];
+            if (dest.state != Fact::live || !dest.typed || dest.type == Variable::_string) return false;
+            // Reading as another type gives a default, so the value only matters when the types match
+            auto Known = [&](size_t slot) {
+                const Fact &fact = facts[slot];
+                return fact.state == Fact::live && fact.typed && (fact.constant || fact.type != dest.type);
+            };
+            auto Value = [&](size_t slot) {
+                return Materialize(facts[slot].type, facts[slot].bits);
+            };
+            size_t left = instruction.operands[1], right = instruction.operands[2];
+            switch (instruction.opcode)
+            {
+                case Opcode::assign_constant:
+                    bits = As(dest.type, instruction.constant);
+                    return true;
+                case Opcode::assign_copy:
+                    if (!Known(left)) return false;
+                    bits = As(dest.type, Value(left));
+                    return true;
+                case Opcode::assign_not:
+                    if (!Known(left)) return false;
+                    switch (dest.type)
+                    {
+                        case Variable::_int: bits = !Value(left).as_int(); break;
+                        case Variable::_float: bits = std::bit_cast<int32_t>((float)!Value(left).as_float()); break;
+                        default: bits = (char)!Value(left).as_char(); break;
+                    }
+                    return true;
+                case Opcode::assign_nothing:
+                case Opcode::assign_wdym:
+                    return false;
+                default:
+                    if (instruction.operation == 0 || !Known(left) || !Known(right)) return false;
+                    return Evaluate(instruction.operation, dest.type, Value(left), Value(right), bits);
+            }
+        };
+
+        // Whether an assignment does nothing but store into operands[0], no complaints, no quitting, no traps
+        auto Pure = [&](const std::vector<Fact> &facts, const Instruction &instruction) -> bool {
+            const Fact &dest = facts[instruction.operands[0]];
+            if (dest.state != Fact::live || !dest.typed) return false;
+            auto Live = [&](size_t slot) {
+                return facts[slot].state == Fact::live;
+            };
+            size_t left = instruction.operands[1], right = instruction.operands[2];
+            switch (instruction.opcode)
+            {
+                case Opcode::assign_constant:
+                case Opcode::assign_nothing:
+                    return true;
+                case Opcode::assign_wdym:
+                    return false;
+                case Opcode::assign_copy:
+                    return Live(left);
+                case Opcode::assign_not:
+                    return Live(left) && dest.type != Variable::_string;
+                default:
+                    break;
+            }
+            if (!Live(left) || !Live(right)) return false;
+            char operation = instruction.operation;
+            if (dest.type == Variable::_string) return operation == '+' || operation == '-';
+            if ((operation == '/' || operation == '%') && dest.type != Variable::_float)
+            {
+                // Only a divisor that is known and can't trap
+                const Fact &divisor = facts[right];
+                if (!divisor.typed || (!divisor.constant && divisor.type == dest.type)) return false;
+                int32_t value = As(dest.type, Materialize(divisor.type, divisor.bits));
+                return value != 0 && value != -1;
+            }
+            return true;
+        };
+
+        // Forget every copy that involves a slot that just changed
+        auto Overwrite = [](FlowState &state, size_t slot) {
+            std::erase_if(state.copies, [&](const std::pair<size_t, size_t> &copy) {
+                return copy.first == slot || copy.second == slot;
+            });
+        };
+
+        // Facts after running one instruction, given the facts before
+        auto Step = [&](FlowState &state, const Instruction &instruction) {
+            std::vector<Fact> &facts = state.facts;
+            size_t dest = instruction.operands[0], left = instruction.operands[1];
+            switch (instruction.opcode)
+            {
+                case Opcode::declare_int:
+                case Opcode::declare_float:
+                case Opcode::declare_char:
+                case Opcode::declare_string:
+                {
+                    if (facts[dest].state == Fact::live) break; // Already exists, nothing happens
+                    Overwrite(state, dest);
+                    if (facts[dest].state == Fact::unknown)
+                    {
+                        facts[dest] = Fact { Fact::live };
+                        break;
+                    }
+                    Variable::Type type = (Variable::Type)((int)instruction.opcode - (int)Opcode::declare_int);
+                    Fact result = { Fact::live, true, false, type };
+                    if (type != Variable::_string)
+                    {
+                        const Fact source = left == none ? Fact {} : facts[left];
+                        Variable initial = type == Variable::_int ? Variable(0) : type == Variable::_float ? Variable(0.0f) : Variable(' ');
+                        if (left != none && source.state == Fact::dead)
+                        {
+                            initial = instruction.constant;
+                        }
+                        if (left == none || source.state == Fact::dead)
+                        {
+                            result.constant = true;
+                            result.bits = As(type, initial);
+                        }
+                        else if (source.state == Fact::live && source.typed && (source.constant || source.type != type))
+                        {
+                            result.constant = true;
+                            result.bits = As(type, Materialize(source.type, source.bits));
+                        }
+                    }
+                    facts[dest] = result;
+                    break;
+                }
+                case Opcode::scan:
+                    if (facts[dest].state == Fact::dead) break;
+                    Overwrite(state, dest);
+                    facts[dest].constant = false;
+                    facts[dest].bits = 0;
+                    break;
+                case Opcode::obliterate:
+                    Overwrite(state, dest);
+                    facts[dest] = Fact { Fact::dead };
+                    break;
+                case Opcode::call:
+                    if (instruction.target == none) break;
+                    for (size_t parameter : program[instruction.target].arguments)
+                    {
+                        Overwrite(state, parameter);
+                        facts[parameter] = Fact {};
+                    }
+                    break;
+                case Opcode::make_local:
+                    Overwrite(state, dest);
+                    facts[dest] = Fact {};
+                    break;
+                case Opcode::go_back:
+                    // Parameters and locals go back to whatever the caller had and any call's result could have been given a value
+                    for (size_t slot : handed)
+                    {
+                        Overwrite(state, slot);
+                        facts[slot] = Fact {};
+                    }
+                    break;
+                default:
+                {
+                    if (!Assigns(instruction.opcode)) break;
+                    // Whatever happens next only happens if it was live, otherwise it quit
+                    if (facts[dest].state != Fact::live) facts[dest] = Fact { Fact::live };
+                    if (instruction.opcode == Opcode::assign_nothing || instruction.opcode == Opcode::assign_wdym) break;
+                    int32_t bits;
+                    bool known = Compute(facts, instruction, bits);
+                    bool copy = instruction.opcode == Opcode::assign_copy && dest != left && facts[dest].typed && facts[left].state == Fact::live && facts[left].typed && facts[left].type == facts[dest].type;
+                    Overwrite(state, dest);
+                    facts[dest].constant = known;
+                    facts[dest].bits = known ? bits : 0;
+                    if (copy) state.copies.push_back({ dest, left });
+                    break;
+                }
+            }
+        };
+
+        auto Join = [](FlowState &into, const FlowState &from) -> bool {
+            if (!into.reached)
+            {
+                into = from;
+                return true;
+            }
+            bool changed = false;
+            for (size_t slot = 0; slot < into.facts.size(); slot++)
+            {
+                Fact &a = into.facts[slot];
+                const Fact &b = from.facts[slot];
+                if (a == b) continue;
+                Fact joined;
+                if (a.state != b.state) joined = Fact {};
+                else if (a.state != Fact::live || !a.typed || !b.typed || a.type != b.type) joined = Fact { a.state };
+                else joined = Fact { Fact::live, true, false, a.type };
+                if (joined == a) continue;
+                a = joined;
+                changed = true;
+            }
+            size_t copies = into.copies.size();
+            std::erase_if(into.copies, [&](const std::pair<size_t, size_t> &copy) {
+                return std::find(from.copies.begin(), from.copies.end(), copy) == from.copies.end();
+            });
+            return changed || copies != into.copies.size();
+        };
+
+        // Basic blocks and the facts where each one starts, empty if the program is too big to bother
+        // The return node is one more block after the real ones, it has no instructions and goes on after every call
+        struct Flow {
+            std::vector<size_t> starts; // First instruction of each block, plus the end
+            std::vector<size_t> block;  // Block of each instruction
+            std::vector<FlowState> entry;
+            std::vector<size_t> call_sites;
+            size_t returned = 0; // The return node
+        };
+        auto Analyze = [&]() -> Flow {
+            Flow flow;
+            if ((program.size() + 1) * (variables.size() + 1) > max_flow_cells) return flow;
+            std::vector<size_t> next;
+            std::vector<bool> leader(program.size() + 1);
+            leader[0] = true;
+            for (size_t k = 0; k < program.size(); k++)
+            {
+                Successors(k, next);
+                if (next.size() == 1 && next[0] == k + 1) continue;
+                leader[k + 1] = true; // After a call too, which is where its return lands
+                for (size_t target : next)
+                {
+                    if (target != none) leader[target] = true;
+                }
+            }
+            for (size_t k = 0; k < program.size(); k++)
+            {
+                if (leader[k]) flow.starts.push_back(k);
+                flow.block.push_back(flow.starts.size() - 1);
+            }
+            flow.starts.push_back(program.size());
+            size_t blocks = flow.starts.size() - 1;
+            flow.call_sites = CallSites();
+            flow.returned = blocks;
+
+            // The file starts with whatever the files before it left behind
+            flow.entry.resize(blocks + 1);
+            FlowState &start = flow.entry[0];
+            start.reached = true;
+            start.facts.resize(variables.size());
+            for (size_t slot = 0; slot < variables.size(); slot++)
+            {
+                if (variables[slot].live) start.facts[slot] = Fact { Fact::live, true, false, variables[slot].type };
+                else start.facts[slot] = Fact { Fact::dead };
+            }
+
+            std::vector<size_t> worklist = { 0 };
+            std::vector<bool> queued(blocks + 1);
+            queued[0] = true;
+            while (!worklist.empty())
+            {
+                size_t b = worklist.back();
+                worklist.pop_back();
+                queued[b] = false;
+                FlowState state = flow.entry[b];
+                next.clear();
+                if (b == flow.returned)
+                {
+                    for (size_t site : flow.call_sites) next.push_back(site + 1);
+                }
+                else
+                {
+                    for (size_t k = flow.starts[b]; k < flow.starts[b + 1]; k++) Step(state, program[k]);
+                    Successors(flow.starts[b + 1] - 1, next);
+                }
+                for (size_t target : next)
+                {
+                    size_t successor = target == none ? flow.returned : flow.block[target];
+                    if (Join(flow.entry[successor], state) && !queued[successor])
+                    {
+                        queued[successor] = true;
+                        worklist.push_back(successor);
+                    }
+                }
+            }
+            return flow;
+        };
+
+        // Don't let the optimizer make return land somewhere else, those indices came from another file
+        if (!goneto_stack.empty())
+        {
+            report.skipped = "calls from the previous file are still waiting to return";
+            report.after = program.size();
+            return report;
+        }
+
+        // Jumps to a label that just goes somewhere else go there directly
+        for (Instruction &instruction : program)
+        {
+            if (!Jumps(instruction.opcode) || instruction.target == none) continue;
+            // Which label a call lands on decides its parameters, so those stay put
+            auto Takes = [&](size_t label) {
+                return instruction.opcode == Opcode::call && !program[label].arguments.empty();
+            };
+            size_t target = instruction.target;
+            for (size_t hops = 0; hops < program.size() && !Takes(target); hops++)
+            {
+                size_t land = target + 1;
+                while (program[land].opcode == Opcode::label) land++;
+                if (program[land].opcode != Opcode::go_to || program[land].target == none || program[land].target == target || Takes(program[land].target)) break;
+                target = program[land].target;
+            }
+            if (target == instruction.target) continue;
+            instruction.target = target;
+            report.rewritten[(size_t)Pass::threading]++;
+        }
+
+        // Constants: assignments that always store the same thing, branches that always go the same way
+        Flow flow = Analyze();
+        if (!flow.starts.empty())
+        {
+            std::vector<bool> removed(program.size());
+            for (size_t b = 0; b + 1 < flow.starts.size(); b++)
+            {
+                if (!flow.entry[b].reached) continue;
+                FlowState state = flow.entry[b];
+                for (size_t k = flow.starts[b]; k < flow.starts[b + 1]; k++)
+                {
+                    Instruction &instruction = program[k];
+                    const std::vector<Fact> &facts = state.facts;
+                    int32_t bits;
+                    if (Assigns(instruction.opcode) && instruction.operation != 0 && instruction.opcode != Opcode::assign_constant && Compute(facts, instruction, bits))
+                    {
+                        instruction.opcode = Opcode::assign_constant;
+                        instruction.constant = Materialize(facts[instruction.operands[0]].type, bits);
+                        report.rewritten[(size_t)Pass::folding]++;
+                    }
+                    else if (instruction.opcode == Opcode::branch || instruction.opcode == Opcode::exists)
+                    {
+                        const Fact &fact = facts[instruction.operands[0]];
+                        int taken = -1;
+                        if (instruction.opcode == Opcode::exists && fact.state != Fact::unknown) taken = fact.state == Fact::live;
+                        if (instruction.opcode == Opcode::branch && fact.state == Fact::live && fact.typed)
+                        {
+                            // Same odd rules as the interpreter: floats never jump, chars always do
+                            if (fact.type == Variable::_float) taken = false;
+                            else if (fact.type == Variable::_char) taken = true;
+                            else if (fact.type == Variable::_int && fact.constant) taken = fact.bits != 0;
+                        }
+                        if (taken == 0)
+                        {
+                            removed[k] = true;
+                        }
+                        else if (taken == 1 && instruction.target != none)
+                        {
+                            instruction.opcode = Opcode::go_to;
+                            report.rewritten[(size_t)Pass::folding]++;
+                        }
+                    }
+                    Step(state, instruction);
+                }
+            }
+            report.removed[(size_t)Pass::folding] = Compact(removed);
+        }
 
-                auto WhereVar = [&](std::string name) -> size_t {
-                    size_t location = (size_t)-1;
-                    for (size_t j = 0; j < variables.size(); j++)
-                    {
-                        if (variables[j].name == name)
+        // Copies: read the original instead, so the copy itself can become a dead store
+        flow = Analyze();
+        if (!flow.starts.empty())
+        {
+            for (size_t b = 0; b + 1 < flow.starts.size(); b++)
+            {
+                if (!flow.entry[b].reached) continue;
+                FlowState state = flow.entry[b];
+                for (size_t k = flow.starts[b]; k < flow.starts[b + 1]; k++)
+                {
+                    Instruction &instruction = program[k];
+                    auto Propagate = [&](size_t &operand) {
+                        for (const auto &[copy, original] : state.copies)
                         {
-                            location = j;
+                            if (copy != operand) continue;
+                            operand = original;
+                            report.rewritten[(size_t)Pass::propagation]++;
+                            return;
                         }
+                    };
+                    switch (instruction.opcode)
+                    {
+                        case Opcode::declare_int:
+                        case Opcode::declare_float:
+                        case Opcode::declare_char:
+                        case Opcode::declare_string:
+                            if (instruction.operands[1] != none) Propagate(instruction.operands[1]);
+                            break;
+                        case Opcode::print:
+                        case Opcode::branch:
+                            Propagate(instruction.operands[0]);
+                            break;
+                        case Opcode::assign_copy:
+                        case Opcode::assign_not:
+                            Propagate(instruction.operands[1]);
+                            break;
+                        default:
+                            if (!Assigns(instruction.opcode) || instruction.operation == 0 || instruction.opcode == Opcode::assign_constant) break;
+                            Propagate(instruction.operands[1]);
+                            Propagate(instruction.operands[2]);
+                            break;
                     }
-                    return location;
-                };
+                    Step(state, instruction);
+                }
+            }
+        }
+
+        // Dead stores: nothing reads the value before it is overwritten, deleted or the program ends
+        // Removing one can kill the stores feeding it, so go around until nothing changes
+        for (;;)
+        {
+            flow = Analyze();
+            if (flow.starts.empty()) break;
+            size_t blocks = flow.starts.size() - 1;
+            const size_t slots = variables.size();
 
-                if (tokens[0] == "int" || tokens[0] == "whole_number")
+            // What the forward facts say about each instruction, so the backward walk doesn't need them
+            enum Effect : unsigned char {
+                may_quit = 1, // Assigns into something that might not exist, which ends the program with everything in it
+                pure = 2,     // Only stores into operands[0]
+                creates = 4   // Declares something that was dead
+            };
+            std::vector<unsigned char> effects(program.size());
+            for (size_t b = 0; b < blocks; b++)
+            {
+                if (!flow.entry[b].reached) continue;
+                FlowState state = flow.entry[b];
+                for (size_t k = flow.starts[b]; k < flow.starts[b + 1]; k++)
                 {
-                    if (WhereVar(tokens[1]) == (size_t)-1)
+                    const Instruction &instruction = program[k];
+                    if (Assigns(instruction.opcode))
                     {
-                        int value = 0;
-                        if (tokens[2] == "=")
+                        if (state.facts[instruction.operands[0]].state != Fact::live) effects[k] |= may_quit;
+                        if (Pure(state.facts, instruction)) effects[k] |= pure;
+                    }
+                    if (instruction.opcode >= Opcode::declare_int && instruction.opcode <= Opcode::declare_string && state.facts[instruction.operands[0]].state == Fact::dead) effects[k] |= creates;
+                    Step(state, instruction);
+                }
+            }
+
+            // Live means the value might still be read, everything is live when the program ends
+            auto Backward = [&](size_t k, std::vector<bool> &live, bool remove) -> bool {
+                const Instruction &instruction = program[k];
+                size_t dest = instruction.operands[0];
+                switch (instruction.opcode)
+                {
+                    case Opcode::finish:
+                        live.assign(slots, true);
+                        return false;
+                    case Opcode::escape:
+                        live.assign(slots, false);
+                        return false;
+                    case Opcode::declare_int:
+                    case Opcode::declare_float:
+                    case Opcode::declare_char:
+                    case Opcode::declare_string:
+                        if (effects[k] & creates) live[dest] = false;
+                        if (instruction.operands[1] != none) live[instruction.operands[1]] = true;
+                        return false;
+                    case Opcode::print:
+                    case Opcode::branch:
+                        live[dest] = true;
+                        return false;
+                    case Opcode::obliterate:
+                        live[dest] = false;
+                        return false;
+                    case Opcode::call:
+                        // Arguments are read and parameters are set aside to be put back
+                        for (size_t argument : instruction.arguments) live[argument] = true;
+                        if (instruction.target != none)
                         {
-                            size_t varloc = WhereVar(tokens[3]);
-                            if (varloc == (size_t)-1)
-                            {
-                                value = ToInt(tokens[3]);
-                            }
-                            else
-                            {
-                                value = variables[varloc].value_int;
-                            }
+                            for (size_t parameter : program[instruction.target].arguments) live[parameter] = true;
                         }
-                        variables.push_back(Variable { .name = tokens[1], .type = Variable::_int, .value_int = value });
-                        yesbug << "You defined int named " << green << tokens[1] << reset << " with value " << value << '\n';
+                        return false;
+                    case Opcode::go_back:
+                        if (dest != none) live[dest] = true;
+                        return false;
+                    case Opcode::make_local:
+                        live[dest] = true; // Set aside to be put back
+                        return false;
+                    default:
+                        break;
+                }
+                if (!Assigns(instruction.opcode)) return false;
+                if (effects[k] & may_quit)
+                {
+                    live.assign(slots, true);
+                    return false;
+                }
+                if ((effects[k] & pure) && remove && (!live[dest] || instruction.opcode == Opcode::assign_nothing)) return true;
+                if (effects[k] & pure) live[dest] = false;
+                switch (instruction.opcode)
+                {
+                    case Opcode::assign_copy:
+                    case Opcode::assign_not:
+                        live[instruction.operands[1]] = true;
+                        break;
+                    case Opcode::assign_constant:
+                    case Opcode::assign_nothing:
+                    case Opcode::assign_wdym:
+                        break;
+                    default:
+                        if (instruction.operation == 0) break;
+                        live[instruction.operands[1]] = true;
+                        live[instruction.operands[2]] = true;
+                        break;
+                }
+                return false;
+            };
+
+            // live_in[flow.returned] is what is live after any call, what every return hands on
+            std::vector<size_t> next;
+            std::vector<std::vector<bool>> live_in(blocks + 1, std::vector<bool>(slots));
+            auto LiveOut = [&](size_t b) {
+                std::vector<bool> live(slots);
+                next.clear();
+                if (b == flow.returned)
+                {
+                    for (size_t site : flow.call_sites) next.push_back(site + 1);
+                }
+                else Successors(flow.starts[b + 1] - 1, next);
+                for (size_t target : next)
+                {
+                    const std::vector<bool> &in = live_in[target == none ? flow.returned : flow.block[target]];
+                    for (size_t slot = 0; slot < slots; slot++) live[slot] = live[slot] || in[slot];
+                }
+                return live;
+            };
+            for (bool changed = true; changed;)
+            {
+                changed = false;
+                std::vector<bool> returned = LiveOut(flow.returned);
+                if (returned != live_in[flow.returned])
+                {
+                    live_in[flow.returned] = std::move(returned);
+                    changed = true;
+                }
+                for (size_t b = blocks; b-- > 0;)
+                {
+                    std::vector<bool> live = LiveOut(b);
+                    for (size_t k = flow.starts[b + 1]; k-- > flow.starts[b];) Backward(k, live, false);
+                    if (live != live_in[b])
+                    {
+                        live_in[b] = std::move(live);
+                        changed = true;
                     }
-                    else
+                }
+            }
+
+            std::vector<bool> removed(program.size());
+            for (size_t b = 0; b < blocks; b++)
+            {
+                if (!flow.entry[b].reached) continue;
+                std::vector<bool> live = LiveOut(b);
+                for (size_t k = flow.starts[b + 1]; k-- > flow.starts[b];) removed[k] = Backward(k, live, true);
+            }
+            size_t count = Compact(removed);
+            report.removed[(size_t)Pass::dead_stores] += count;
+            if (count == 0) break;
+        }
+
+        // Unreachable code: whatever nothing can get to, except labels something still jumps to
+        {
+            std::vector<size_t> call_sites = CallSites();
+            std::vector<size_t> next;
+            std::vector<bool> reached(program.size());
+            bool returned = false;
+            std::vector<size_t> worklist = { 0 };
+            reached[0] = true;
+            while (!worklist.empty())
+            {
+                size_t k = worklist.back();
+                worklist.pop_back();
+                Successors(k, next);
+                // The first return reached makes every call's next instruction reachable, later ones add nothing
+                if (!next.empty() && next.back() == none)
+                {
+                    next.pop_back();
+                    if (!returned)
                     {
-                        Diagnose(i, "Variable " + red + tokens[1] + reset + " already exists\n");
+                        for (size_t site : call_sites) next.push_back(site + 1);
                     }
+                    returned = true;
+                }
+                for (size_t target : next)
+                {
+                    if (reached[target]) continue;
+                    reached[target] = true;
+                    worklist.push_back(target);
+                }
+            }
+            std::vector<bool> removed(program.size());
+            for (size_t k = 0; k + 1 < program.size(); k++) removed[k] = !reached[k];
+            for (const Instruction &instruction : program)
+            {
+                if (Jumps(instruction.opcode) && instruction.target != none) removed[instruction.target] = false;
+            }
+            report.removed[(size_t)Pass::unreachable] = Compact(removed);
+        }
+
+        report.after = program.size();
+        return report;
+    };
+
+    // The same program as standalone C++, labels become gotos and calls push onto a real stack
+    auto EmitCpp = [&](const Program &compiled, const std::vector<std::string_view> &lines, const std::string &filename) -> std::string {
+        const std::vector<Instruction> &program = compiled.instructions;
+
+        auto Quote = [](std::string_view text) -> std::string {
+            std::string quoted = "\"";
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\') quoted += std::string("\\") + c;
+                else if (c == '\n') quoted += "\\n";
+                else if (c == '\t') quoted += "\\t";
+                else if ((unsigned char)c < ' ' || c == 127)
+                {
+                    char octal[5];
+                    std::snprintf(octal, sizeof(octal), "\\%03o", (unsigned char)c);
+                    quoted += octal;
                 }
-                else if (tokens[0] == "float" || tokens[0] == "fake_or_real_number")
+                else quoted += c;
+            }
+            return quoted + "\"";
+        };
+
+        auto Float = [](float value) -> std::string {
+            if (std::isnan(value)) return "NAN";
+            if (std::isinf(value)) return value < 0 ? "-INFINITY" : "INFINITY";
+            char hex[32];
+            std::snprintf(hex, sizeof(hex), "%af", value);
+            return hex;
+        };
+
+        // Only instructions something continues from get a C++ label, so nothing is unused
+        std::vector<bool> landed(program.size() + 1);
+        std::vector<size_t> call_sites;
+        bool returns = false;
+
+        // IsTailCall without the stack, which the translation checks when it runs
+        auto TailCall = [&](size_t k) {
+            const Instruction &call = program[k];
+            const Instruction &next = program[k + 1];
+            return next.opcode == Opcode::go_back && next.operands[0] == (size_t)-1 && call.arguments.empty() && call.operands[0] == (size_t)-1 && program[call.target].arguments.empty();
+        };
+        // Calls whose frame only has to be popped (CallStack::bare), as long as they made no locals
+        std::vector<size_t> bare_sites;
+        bool tail_calls = false;
+        for (size_t k = 0; k < program.size(); k++)
+        {
+            const Instruction &instruction = program[k];
+            switch (instruction.opcode)
+            {
+                case Opcode::call:
+                    if (instruction.target == (size_t)-1) break;
+                    call_sites.push_back(k);
+                    if (instruction.operands[0] == (size_t)-1 && program[instruction.target].arguments.empty()) bare_sites.push_back(k);
+                    tail_calls |= TailCall(k);
+                    landed[k + 1] = true;
+                    landed[instruction.target + 1] = true;
+                    break;
+                case Opcode::go_to:
+                case Opcode::branch:
+                case Opcode::exists:
+                    if (instruction.target != (size_t)-1) landed[instruction.target + 1] = true;
+                    break;
+                case Opcode::jmp:
+                    landed[instruction.target + 1] = true;
+                    break;
+                case Opcode::go_back:
+                    returns = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        std::ostringstream out;
+        out << "// " << filename << " translated by lastsmall --emit-cpp, edit that one instead\n";
+        out << "// Build with g++ -std=c++20 -O2\n";
+        out << "#ifndef FRUSTRATION_MULTIPLIER\n#define FRUSTRATION_MULTIPLIER " << FRUSTRATION_MULTIPLIER << "\n#endif\n";
+        out << cpp_prelude_head << '\n';
+        size_t slots = std::max<size_t>(symbols.names.size(), 1);
+        out << "static Variable v[" << slots << "];\n";
+        out << "static const char *const names[" << slots << "] = {";
+        for (size_t slot = 0; slot < symbols.names.size(); slot++) out << (slot ? ", " : " ") << Quote(symbols.names[slot]);
+        out << " };\n";
+        out << cpp_prelude_body << '\n';
+        out << "int main()\n{\n";
+        out << "    std::ios::sync_with_stdio(false);\n";
+        out << "    std::vector<size_t> stack;\n";
+        out << "    std::vector<size_t> marks;\n";   // Where each call's locals start
+        out << "    std::vector<Variable> saved;\n"; // Parameters set aside by calls, in order
+        if (tail_calls)
+        {
+            out << "    auto bare = [](size_t site) {\n        switch (site)\n        {\n";
+            for (size_t site : bare_sites) out << "            case " << site << ":\n";
+            if (!bare_sites.empty()) out << "                return true;\n";
+            out << "            default:\n                return false;\n        }\n    };\n";
+        }
+        if (returns) out << "    Variable returned;\n    size_t returned_line = 0, returned_from = 0;\n";
+
+        // The interpreter complains about these while loading, so the translation does too
+        for (const auto &[line, what] : compiled.complaints) out << "    diagnose(" << line << ", " << Quote(what) << ");\n";
+
+        auto Goto = [](size_t target) {
+            return "goto at_" + std::to_string(target + 1) + ";";
+        };
+        auto LabelMissing = [&](const Instruction &instruction, const std::string &rest) {
+            return "diagnose(" + std::to_string(instruction.line) + ", \"Label \" + red + " + Quote(instruction.text) + " + reset + " + Quote(rest) + ");";
+        };
+        const std::string not_found = " was not found in the entire file at all... what are you doing??\n";
+        const std::string not_found_branch = " was not found in the entire file at all to be branched... like how the heck are you...\n";
+
+        for (size_t k = 0; k < program.size(); k++)
+        {
+            const Instruction &instruction = program[k];
+            if (landed[k]) out << "at_" << k << ":;\n";
+            if (instruction.opcode == Opcode::finish)
+            {
+                out << "    goto finished;\n";
+                break;
+            }
+
+            // A backslash at the end would glue the next line onto the comment
+            std::string source = std::string(lines[instruction.line]);
+            while (!source.empty() && (source.back() == '\\' || std::isspace((unsigned char)source.back()))) source.pop_back();
+            out << "    // #" << instruction.line + 1 << ": " << source << '\n';
+
+            std::string line = std::to_string(instruction.line);
+            std::string dest = std::to_string(instruction.operands[0]);
+            std::string left = std::to_string(instruction.operands[1]);
+            std::string right = std::to_string(instruction.operands[2]);
+            bool initialized = instruction.operands[1] != (size_t)-1;
+            auto Declare = [&](const std::string &from_variable, const std::string &from_text, const std::string &otherwise) {
+                out << "    declare(" << line << ", " << dest << ", ";
+                if (initialized) out << "v[" << left << "].live ? Variable::of(v[" << left << "]." << from_variable << "()) : Variable::of(" << from_text << ")";
+                else out << "Variable::of(" << otherwise << ")";
+                out << ");\n";
+            };
+            auto Assign = [&](char kind) {
+                out << "if (!assign(" << line << ", '" << kind << "', " << dest << ", " << (instruction.operands[1] == (size_t)-1 ? "0" : left) << ", " << (instruction.operands[2] == (size_t)-1 ? "0" : right) << ")) goto finished;\n";
+            };
+            // The compiler proved the types once, so check them and skip straight to the math
+            auto Typed = [&](const char *type, const char *field, const char *operation) {
+                out << "    if (v[" << dest << "].holds(Variable::" << type << ") && v[" << left << "].holds(Variable::" << type << ") && v[" << right << "].holds(Variable::" << type << ")) ";
+                out << "v[" << dest << "]." << field << " = v[" << left << "]." << field << ' ' << operation << " v[" << right << "]." << field << ";\n";
+                out << "    else ";
+                Assign(instruction.operation);
+            };
+
+            switch (instruction.opcode)
+            {
+                case Opcode::label:
+                    break;
+                case Opcode::declare_int:
+                    Declare("as_int", "(int)" + std::to_string(instruction.constant.value_int), "0");
+                    break;
+                case Opcode::declare_float:
+                    Declare("as_float", Float(instruction.constant.value_float), "0.0f");
+                    break;
+                case Opcode::declare_char:
+                    Declare("as_char", "(char)" + std::to_string((int)instruction.constant.value_char), "' '");
+                    break;
+                case Opcode::declare_string:
+                    Declare("as_string", "std::string(" + Quote(instruction.text) + ", " + std::to_string(instruction.text.size()) + ")", "std::string()");
+                    break;
+                case Opcode::call:
                 {
-                    if (WhereVar(tokens[1]) == (size_t)-1)
+                    if (instruction.target == (size_t)-1)
                     {
-                        float value = 0;
-                        if (tokens[2] == "=")
-                        {
-                            size_t varloc = WhereVar(tokens[3]);
-                            if (varloc == (size_t)-1)
-                            {
-                                value = ToFloat(tokens[3]);
-                            }
-                            else
-                            {
-                                value = variables[varloc].value_float;
-                            }
-                        }
-                        variables.push_back(Variable { .name = tokens[1], .type = Variable::_float, .value_float = value });
-                        yesbug << "You defined float named " << green << tokens[1] << reset << " with value " << value << '\n';
+                        out << "    " << LabelMissing(instruction, not_found) << '\n';
+                        break;
                     }
-                    else
+                    // Same tail calls and the same depth cap as the interpreter, or deep recursion ends differently
+                    if (TailCall(k)) out << "    if (!stack.empty() && locals.size() == marks.back() && bare(stack.back())) " << Goto(instruction.target) << '\n';
+                    out << "    if (stack.size() >= " << goneto_stack.capacity() << ") diagnose(" << line << ", \"Calls are already \" + red + \"" << goneto_stack.capacity() << "\" + reset + \" deep, not going to \" + red + " << Quote(instruction.text) << " + reset + \". That's infinite recursion and you know it\\n\");\n";
+                    out << "    else\n    {\n";
+                    // Arguments are read before any parameter is touched, in case they are the same variables
+                    const std::vector<size_t> &parameters = program[instruction.target].arguments;
+                    if (!parameters.empty())
                     {
-                        Diagnose(i, "Variable " + red + tokens[1] + reset + " already exists\n");
+                        out << "        Variable passed[] = {";
+                        for (size_t p = 0; p < parameters.size(); p++)
+                        {
+                            out << (p ? ", " : " ");
+                            if (p < instruction.arguments.size()) out << "v[" << instruction.arguments[p] << "]";
+                            else out << "Variable()";
+                        }
+                        out << " };\n";
+                        for (size_t parameter : parameters) out << "        saved.push_back(std::move(v[" << parameter << "]));\n";
+                        for (size_t p = 0; p < parameters.size(); p++) out << "        v[" << parameters[p] << "] = std::move(passed[" << p << "]);\n";
                     }
+                    out << "        stack.push_back(" << k << ");\n        marks.push_back(locals.size());\n        " << Goto(instruction.target) << "\n    }\n";
+                    break;
+                }
+                case Opcode::go_to:
+                    if (instruction.target == (size_t)-1) out << "    " << LabelMissing(instruction, not_found) << '\n';
+                    else out << "    " << Goto(instruction.target) << '\n';
+                    break;
+                case Opcode::jmp:
+                    out << "    " << Goto(instruction.target) << '\n';
+                    break;
+                case Opcode::go_back:
+                    out << "    if (stack.empty()) diagnose(" << line << ", \"You have not gone anywhere before you go back... idiot\\n\");\n";
+                    out << "    else\n    {\n";
+                    if (instruction.operands[0] != (size_t)-1) out << "        returned = v[" << dest << "];\n";
+                    out << "        returned_line = " << line << ";\n";
+                    out << "        returned_from = " << (instruction.operands[0] == (size_t)-1 ? "(size_t)-1" : dest) << ";\n";
+                    out << "        goto go_back;\n    }\n";
+                    break;
+                case Opcode::scan:
+                    out << "    scan(" << line << ", " << dest << ");\n";
+                    break;
+                case Opcode::print:
+                    out << "    print(" << line << ", " << dest << ");\n";
+                    break;
+                case Opcode::obliterate:
+                    out << "    obliterate(" << line << ", " << dest << ");\n";
+                    break;
+                case Opcode::branch:
+                    out << "    if (branches(" << line << ", " << dest << ")) ";
+                    if (instruction.target == (size_t)-1) out << LabelMissing(instruction, not_found_branch) << '\n';
+                    else out << Goto(instruction.target) << '\n';
+                    break;
+                case Opcode::exists:
+                    out << "    if (v[" << dest << "].live) ";
+                    if (instruction.target == (size_t)-1) out << LabelMissing(instruction, not_found_branch) << '\n';
+                    else out << Goto(instruction.target) << '\n';
+                    break;
+                case Opcode::make_local:
+                    out << "    make_local(" << line << ", " << dest << ", marks);\n";
+                    break;
+                case Opcode::escape:
+                    out << "    goto finished;\n";
+                    break;
+                case Opcode::assign_copy:
+                    out << "    ";
+                    Assign('=');
+                    break;
+                case Opcode::assign_not:
+                    out << "    ";
+                    Assign('!');
+                    break;
+                case Opcode::assign_binary:
+                    out << "    ";
+                    Assign(instruction.operation);
+                    break;
+                case Opcode::assign_nothing:
+                    out << "    ";
+                    Assign(' ');
+                    break;
+                case Opcode::assign_wdym:
+                    out << "    ";
+                    Assign('?');
+                    break;
+                case Opcode::add_int: Typed("_int", "value_int", "+"); break;
+                case Opcode::sub_int: Typed("_int", "value_int", "-"); break;
+                case Opcode::mul_int: Typed("_int", "value_int", "*"); break;
+                case Opcode::div_int: Typed("_int", "value_int", "/"); break;
+                case Opcode::mod_int: Typed("_int", "value_int", "%"); break;
+                case Opcode::add_float: Typed("_float", "value_float", "+"); break;
+                case Opcode::sub_float: Typed("_float", "value_float", "-"); break;
+                case Opcode::mul_float: Typed("_float", "value_float", "*"); break;
+                case Opcode::div_float: Typed("_float", "value_float", "/"); break;
+                case Opcode::concat_string: Typed("_string", "value_string", "+"); break;
+                case Opcode::assign_constant:
+                {
+                    const Variable &constant = instruction.constant;
+                    out << "    if (v[" << dest << "].holds(Variable::" << (constant.type == Variable::_int ? "_int" : constant.type == Variable::_float ? "_float" : "_char") << ")) ";
+                    if (constant.type == Variable::_int) out << "v[" << dest << "].value_int = (int)" << constant.value_int << ";\n";
+                    else if (constant.type == Variable::_float) out << "v[" << dest << "].value_float = " << Float(constant.value_float) << ";\n";
+                    else out << "v[" << dest << "].value_char = (char)" << (int)constant.value_char << ";\n";
+                    out << "    else ";
+                    Assign(instruction.operation);
+                    break;
+                }
+                case Opcode::finish:
+                    break;
+            }
+        }
+
+        // Every return comes here and goes back to whichever call pushed the site
+        if (returns)
+        {
+            out << "go_back:\n    {\n        size_t site = stack.back();\n        stack.pop_back();\n";
+            out << "        put_back_locals(marks.back());\n        marks.pop_back();\n";
+            out << "        switch (site)\n        {\n";
+            for (size_t site : call_sites)
+            {
+                // The caller's parameters come back in reverse, then the value goes where the call asked
+                const Instruction &call = program[site];
+                const std::vector<size_t> &parameters = program[call.target].arguments;
+                out << "            case " << site << ":\n";
+                for (size_t p = parameters.size(); p-- > 0;) out << "                v[" << parameters[p] << "] = std::move(saved.back());\n                saved.pop_back();\n";
+                if (call.operands[0] != (size_t)-1) out << "                give_back(returned_line, " << call.operands[0] << ", returned_from, returned);\n";
+                out << "                " << Goto(site) << '\n';
+            }
+            out << "        }\n    }\n";
+        }
+        out << "finished:\n    return 0;\n}\n";
+        return out.str();
+    };
+
+    if (!trace_path.empty() && !trace.open(trace_path, filenames))
+    {
+        std::cout << "Couldn't even write " << red << trace_path << reset << ". Running blind\n";
+    }
+    // Only this thread runs anything, it gets its ring once instead of asking every instruction
+    TraceRecorder::Ring *tracing = trace.enabled() ? &trace.ring() : nullptr;
+    bool profiling = !profile_path.empty();
+    Profiler profiler;
+
+    // With --jobs this process only hands files out and waits, each worker comes back here with the one file it runs
+    std::optional<Workers> workers;
+    bool waited = false;
+    size_t only = (size_t)-1;
+    if (jobs && filenames.size() > 1)
+    {
+        workers.emplace(jobs, (size_t)Witch::count);
+        std::optional<size_t> mine = workers->run(filenames);
+        if (mine)
+        {
+            only = *mine;
+            if (tracing) tracing->chunk.thread = (uint32_t)only + 1;
+            if (profiling) profile_path += "." + std::to_string(only + 1); // Everyone writing the same report would leave only the last one
+        }
+        else
+        {
+            waited = true;
+            std::copy(workers->witches().begin(), workers->witches().end(), witch_counts.begin());
+        }
+    }
+    size_t missing_files = 0;
+
+    for (const std::string &filename : filenames)
+    {
+        size_t index = &filename - filenames.data();
+        if (waited || (only != (size_t)-1 && index != only)) continue;
+        running_file = filename;
+        running_since = std::chrono::steady_clock::now();
+        // Lines are views into the mapped file, it stays mapped until this file is done running
+        MappedFile source(filename);
+        bool missing = source.fail();
+        if (missing)
+        {
+            Diagnose((size_t)-1, Witch::missing_file, "", "You idiot. You didn't realize that " + red + filename + reset + " does not exist... bruh moment\n");
+            missing_files++;
+        }
+        std::vector<std::string_view> lines = split_lines(source.text());
+
+        // Straight from filename.lsmc when it was made from these exact lines, otherwise compiled and saved for next time
+        std::optional<Program> cached = cache ? LoadCache(filename, lines) : std::nullopt;
+        Program compiled = cached ? std::move(*cached) : Compile(lines);
+        if (cache && !cached && !missing) SaveCache(filename, lines, compiled);
+        const std::vector<Instruction> &program = compiled.instructions;
+
+        OptimizerReport optimized;
+        if (debug) optimized.skipped = "--debug wants to see every line as it was written";
+        else optimized = Optimize(compiled);
+        if (opt_report)
+        {
+            if (!optimized.skipped.empty())
+            {
+                std::cout << green << filename << reset << ": not optimized, " << optimized.skipped << '\n';
+            }
+            else
+            {
+                std::cout << green << filename << reset << ": " << optimized.before << " -> " << optimized.after << " instructions\n";
+                const char *const rewrites[] = { " jumps rethreaded", " folded", " operands propagated", "", "" };
+                for (size_t pass = 0; pass < (size_t)Pass::count; pass++)
+                {
+                    std::cout << "    " << std::left << std::setw(24) << pass_names[pass] << std::right << optimized.removed[pass] << " removed";
+                    if (*rewrites[pass]) std::cout << ", " << optimized.rewritten[pass] << rewrites[pass];
+                    std::cout << '\n';
                 }
-                else if (tokens[0] == "char" || tokens[0] == "idk_ascii_character")
+            }
+        }
+
+        if (emit_cpp)
+        {
+            // filename.lsm becomes filename.cpp, never the file itself
+            size_t dot = filename.rfind('.');
+            size_t slash = filename.find_last_of("/\\");
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = filename.size();
+            std::string output = filename.substr(0, dot) + ".cpp";
+            if (output == filename) output += ".cpp";
+
+            std::ofstream ofile = std::ofstream(output);
+            ofile << EmitCpp(compiled, lines, filename);
+            ofile.close();
+            if (ofile.fail())
+            {
+                std::cout << "Couldn't even write " << red << output << reset << ". Not my fault this time\n";
+            }
+            else
+            {
+                std::cout << "Wrote " << green << output << reset << ", compiling it is your problem now\n";
+            }
+            continue;
+        }
+
+        // Debug wants to see every line, the trace and the profiler want every instruction, machine code doesn't show any
+        JitCompiler jit_compiler(compiled, goneto_stack);
+        jit_compiler.enabled = jit && !debug && !tracing && !profiling;
+
+        int width = lines.empty() ? 1 : (int)std::log10(lines.size()) + 1;
+        auto Echo = [&](const Instruction &instruction) {
+            if (instruction.opcode == Opcode::finish || instruction.opcode == Opcode::make_local) return;
+            std::cout << green << filename << reset << ": # " << std::setw(width) << green << instruction.line + 1 << reset << " : " << lines[instruction.line] << '\n';
+        };
+        uint16_t file_index = (uint16_t)index;
+
+        // Everyone who wants to see each instruction before it runs, one check for all of them when nobody does
+        bool watched = debug || tracing || profiling;
+        auto Watch = [&](size_t i, const Instruction &instruction) {
+            if (debug) Echo(instruction);
+            if (tracing) tracing->record(i, instruction, file_index);
+            if (profiling) profiler.step(i, instruction, program, goneto_stack);
+        };
+        if (profiling) profiler.start(filename, lines.size(), goneto_stack.size());
+
+        // Every handler fetches and jumps to the next one itself (threaded), or goes back around the switch
+#if THREADED_DISPATCH
+#define OPCODE(name) op_##name:
+#define NEXT()                                             \
+    do                                                     \
+    {                                                      \
+        instruction = &program[++i];                       \
+        if (watched) Watch(i, *instruction);               \
+        goto *dispatch_table[(size_t)instruction->opcode]; \
+    } while (0)
+#else
+#define OPCODE(name) case Opcode::name:
+#define NEXT() continue
+#endif
+
+        size_t i = (size_t)-1;
+        const Instruction *instruction = nullptr;
+        for (;;)
+        {
+            try
+            {
+#if THREADED_DISPATCH
+                // Same order as Opcode
+                static const void *const dispatch_table[] = {
+                    &&op_label,
+                    &&op_declare_int,
+                    &&op_declare_float,
+                    &&op_declare_char,
+                    &&op_declare_string,
+                    &&op_call,
+                    &&op_go_to,
+                    &&op_jmp,
+                    &&op_go_back,
+                    &&op_scan,
+                    &&op_print,
+                    &&op_obliterate,
+                    &&op_branch,
+                    &&op_exists,
+                    &&op_make_local,
+                    &&op_escape,
+                    &&op_assign_copy,
+                    &&op_assign_not,
+                    &&op_assign_binary,
+                    &&op_assign_nothing,
+                    &&op_assign_wdym,
+                    &&op_add_int,
+                    &&op_sub_int,
+                    &&op_mul_int,
+                    &&op_div_int,
+                    &&op_mod_int,
+                    &&op_add_float,
+                    &&op_sub_float,
+                    &&op_mul_float,
+                    &&op_div_float,
+                    &&op_concat_string,
+                    &&op_assign_constant,
+                    &&op_finish
+                };
+                static_assert(sizeof(dispatch_table) / sizeof(dispatch_table[0]) == (size_t)Opcode::finish + 1, "Dispatch table is missing an opcode");
+                NEXT();
+#else
+                for (;;)
                 {
-                    if (WhereVar(tokens[1]) == (size_t)-1)
+                    instruction = &program[++i];
+                    if (watched) Watch(i, *instruction);
+                    switch (instruction->opcode)
                     {
-                        char value = ' ';
-                        if (tokens[2] == "=")
+#endif
+                    OPCODE(label)
+                        NEXT();
+
+                    OPCODE(declare_int)
+                        if (!variables[instruction->operands[0]].live)
                         {
-                            size_t varloc = WhereVar(tokens[3]);
-                            if (varloc == (size_t)-1)
+                            int value = 0;
+                            if (instruction->operands[1] != (size_t)-1)
                             {
-                                value = ToChar(tokens[3]);
+                                if (!variables[instruction->operands[1]].live)
+                                {
+                                    value = instruction->constant.value_int;
+                                }
+                                else
+                                {
+                                    value = variables[instruction->operands[1]].as_int();
+                                }
                             }
-                            else
+                            variables[instruction->operands[0]] = Variable(value);
+                            yesbug << "You defined int named " << green << symbols.names[instruction->operands[0]] << reset << " with value " << value << '\n';
+                        }
+                        else
+                        {
+                            Diagnose(instruction->line, Witch::already_exists, symbols.names[instruction->operands[0]], "Variable " + red + symbols.names[instruction->operands[0]] + reset + " already exists\n");
+                        }
+                        NEXT();
+
+                    OPCODE(declare_float)
+                        if (!variables[instruction->operands[0]].live)
+                        {
+                            float value = 0;
+                            if (instruction->operands[1] != (size_t)-1)
+                            {
+                                if (!variables[instruction->operands[1]].live)
+                                {
+                                    value = instruction->constant.value_float;
+                                }
+                                else
+                                {
+                                    value = variables[instruction->operands[1]].as_float();
+                                }
+                            }
+                            variables[instruction->operands[0]] = Variable(value);
+                            yesbug << "You defined float named " << green << symbols.names[instruction->operands[0]] << reset << " with value " << value << '\n';
+                        }
+                        else
+                        {
+                            Diagnose(instruction->line, Witch::already_exists, symbols.names[instruction->operands[0]], "Variable " + red + symbols.names[instruction->operands[0]] + reset + " already exists\n");
+                        }
+                        NEXT();
+
+                    OPCODE(declare_char)
+                        if (!variables[instruction->operands[0]].live)
+                        {
+                            char value = ' ';
+                            if (instruction->operands[1] != (size_t)-1)
+                            {
+                                if (!variables[instruction->operands[1]].live)
+                                {
+                                    value = instruction->constant.value_char;
+                                }
+                                else
+                                {
+                                    value = variables[instruction->operands[1]].as_char();
+                                }
+                            }
+                            variables[instruction->operands[0]] = Variable(value);
+                            yesbug << "You defined char named " << green << symbols.names[instruction->operands[0]] << reset << " with value " << value << '\n';
+                        }
+                        else
+                        {
+                            Diagnose(instruction->line, Witch::already_exists, symbols.names[instruction->operands[0]], "Variable " + red + symbols.names[instruction->operands[0]] + reset + " already exists\n");
+                        }
+                        NEXT();
+
+                    OPCODE(declare_string)
+                        if (!variables[instruction->operands[0]].live)
+                        {
+                            std::string value = "";
+                            if (instruction->operands[1] != (size_t)-1)
                             {
-                                value = variables[varloc].value_char;
+                                if (!variables[instruction->operands[1]].live)
+                                {
+                                    value = instruction->text;
+                                }
+                                else
+                                {
+                                    value = variables[instruction->operands[1]].as_string();
+                                }
                             }
+                            // A local's long string comes from its frame's arena, so returning frees it
+                            Variable &dest = variables[instruction->operands[0]];
+                            char *memory = nullptr;
+                            if (value.size() > Variable::inline_capacity && !goneto_stack.empty() && goneto_stack.is_local(instruction->operands[0])) memory = goneto_stack.allocate(value.size());
+                            dest.set_string(value, memory);
+                            dest.live = true;
+                            yesbug << "You defined string named " << green << symbols.names[instruction->operands[0]] << reset << " with value " << value << '\n';
+                        }
+                        else
+                        {
+                            Diagnose(instruction->line, Witch::already_exists, symbols.names[instruction->operands[0]], "Variable " + red + symbols.names[instruction->operands[0]] + reset + " already exists\n");
+                        }
+                        NEXT();
+
+                    OPCODE(call)
+                    {
+                        size_t labelloc = instruction->target;
+                        if (labelloc == (size_t)-1)
+                        {
+                            Diagnose(instruction->line, Witch::no_label, instruction->text, "Label " + red + instruction->text + reset + " was not found in the entire file at all... what are you doing??\n");
+                        }
+                        else if (IsTailCall(program, i, goneto_stack))
+                        {
+                            i = labelloc;
+                            yesbug << "Jumping to " << green << instruction->text << reset << " (tail call, no frame)" << '\n';
+                            if (jit_compiler.enabled) i = jit_compiler.enter(i, variables.data());
+                        }
+                        else if (!goneto_stack.push(program, i, variables.data()))
+                        {
+                            Diagnose(instruction->line, Witch::too_deep, instruction->text, "Calls are already " + red + std::to_string(goneto_stack.capacity()) + reset + " deep, not going to " + red + instruction->text + reset + ". That's infinite recursion and you know it\n");
+                        }
+                        else
+                        {
+                            i = labelloc;
+                            yesbug << "Jumping to " << green << instruction->text << reset << '\n';
+                            if (jit_compiler.enabled) i = jit_compiler.enter(i, variables.data());
+                        }
+                        NEXT();
+                    }
+
+                    OPCODE(go_to)
+                    {
+                        size_t labelloc = instruction->target;
+                        if (labelloc != (size_t)-1)
+                        {
+                            i = labelloc;
+                            yesbug << "Jumping to " << green << instruction->text << reset << '\n';
+                            if (jit_compiler.enabled) i = jit_compiler.enter(i, variables.data());
+                        }
+                        else
+                        {
+                            Diagnose(instruction->line, Witch::no_label, instruction->text, "Label " + red + instruction->text + reset + " was not found in the entire file at all... what are you doing??\n");
                         }
-                        variables.push_back(Variable { .name = tokens[1], .type = Variable::_char, .value_char = value });
-                        yesbug << "You defined char named " << green << tokens[1] << reset << " with value " << value << '\n';
-                    }
-                    else
-                    {
-                        Diagnose(i, "Variable " + red + tokens[1] + reset + " already exists\n");
+                        NEXT();
                     }
-                }
-                else if (tokens[0] == "string" || tokens[0] == "letters")
-                {
-                    if (WhereVar(tokens[1]) == (size_t)-1)
-                    {
-                        std::string value = "";
-                        if (tokens[2] == "=")
+
+                    OPCODE(jmp)
+                        i = instruction->target;
+                        NEXT();
+
+                    OPCODE(go_back)
+                        if (goneto_stack.empty())
                         {
-                            size_t varloc = WhereVar(tokens[3]);
-                            if (varloc == (size_t)-1)
-                            {
-                                value = tokens[3];
-                            }
-                            else
+                            Diagnose(instruction->line, Witch::nowhere_to_go_back, "", "You have not gone anywhere before you go back... idiot\n");
+                        }
+                        else
+                        {
+                            // Take the value before the parameters go back to what the caller had
+                            size_t value = instruction->operands[0];
+                            size_t result = goneto_stack.back().result;
+                            bool given = false;
+                            if (result != (size_t)-1)
                             {
-                                value = variables[varloc].value_string;
+                                if (value == (size_t)-1)
+                                {
+                                    Diagnose(instruction->line, Witch::nothing_given_back, symbols.names[result], "Whoever called this wanted " + red + symbols.names[result] + reset + " back and you gave them nothing\n");
+                                }
+                                else if (!variables[value].live)
+                                {
+                                    Diagnose(instruction->line, Witch::no_variable, symbols.names[value], "Variable " + red + symbols.names[value] + reset + " does not exist, so I can't exactly give it back\n");
+                                }
+                                else
+                                {
+                                    returned = variables[value];
+                                    given = true;
+                                }
                             }
+                            i = goneto_stack.pop(variables.data()).from;
+                            if (given) GiveBack(result);
+                            // A call left over from another file can point past the end of this one
+                            if (i >= program.size() - 1) i = program.size() - 2;
+                            yesbug << "Jumping back to #" << green << program[i + 1].line + 1 << reset << '\n';
                         }
-                        variables.push_back(Variable { .name = tokens[1], .type = Variable::_string, .value_string = value });
-                        yesbug << "You defined string named " << green << tokens[1] << reset << " with value " << value << '\n';
-                    }
-                    else
-                    {
-                        Diagnose(i, "Variable " + red + tokens[1] + reset + " already exists\n");
-                    }
-                }
-                else if (tokens[0] == "call" || tokens[0] == "literally_just_call")
-                {
-                    bool found_label = false;
-                    for (size_t j = 0; j < lines.size(); j++)
+                        NEXT();
+
+                    OPCODE(scan)
                     {
-                        std::vector<std::string> jump_tokens = tokenize(lines[j]);
-                        if (jump_tokens.empty()) continue;
-                        if (jump_tokens[1] == ":")
+                        size_t varloc = instruction->operands[0];
+                        if (!variables[varloc].live)
                         {
-                            if (tokens[1] == jump_tokens[0])
+                            Diagnose(instruction->line, Witch::no_variable, symbols.names[varloc], "Well how many freaking times do I have to tell you that variable " + red + symbols.names[varloc] + reset + " does not exist for scanning?? What a jerk...\n");
+                        }
+                        else
+                        {
+                            Variable &var = variables[varloc];
+                            int value_int = 0;
+                            float value_float = 0;
+                            char value_char = 0;
+                            switch (var.type)
                             {
-                                found_label = true;
-                                goneto_stack.push_back(Jump { tokens[1], i });
-                                i = j;
+                                case Variable::_int:
+                                    input.read(value_int);
+                                    var.value_int = value_int;
+                                    break;
+                                case Variable::_float:
+                                    input.read(value_float);
+                                    var.value_float = value_float;
+                                    break;
+                                case Variable::_char:
+                                    input.read(value_char);
+                                    var.value_char = value_char;
+                                    break;
+                                case Variable::_string:
+                                {
+                                    std::string value_string;
+                                    input.read_line(value_string);
+                                    var.set_string(value_string);
+                                    break;
+                                }
                             }
                         }
+                        NEXT();
                     }
-                    if (found_label)
-                    {
-                        yesbug << "Jumping to " << green << tokens[1] << reset << '\n';
-                    }
-                    else
-                    {
-                        Diagnose(i, "Label " + red + tokens[1] + reset + " was not found in the entire file at all... what are you doing??\n");
-                    }
-                }
-                else if (tokens[0] == "goto" || tokens[0] == "literally_just_go")
-                {
-                    bool found_label = false;
-                    for (size_t j = 0; j < lines.size(); j++)
+
+                    OPCODE(print)
                     {
-                        std::vector<std::string> jump_tokens = tokenize(lines[j]);
-                        if (jump_tokens.empty()) continue;
-                        if (jump_tokens[1] == ":")
+                        size_t varloc = instruction->operands[0];
+                        if (!variables[varloc].live)
+                        {
+                            Diagnose(instruction->line, Witch::no_variable, symbols.names[varloc], "Hell no I am not repeating this again... Variable " + red + symbols.names[varloc] + reset + " does not exist for printing\n");
+                        }
+                        else
                         {
-                            if (tokens[1] == jump_tokens[0])
+                            Variable &var = variables[varloc];
+                            switch (var.type)
                             {
-                                found_label = true;
-                                i = j;
+                                case Variable::_int:
+                                    output.put(var.value_int);
+                                    break;
+                                case Variable::_float:
+                                    output.put(var.value_float);
+                                    break;
+                                case Variable::_char:
+                                    output.put(var.value_char);
+                                    break;
+                                case Variable::_string:
+                                    output.put(var.as_string());
+                                    break;
                             }
                         }
+                        NEXT();
                     }
-                    if (found_label)
-                    {
-                        yesbug << "Jumping to " << green << tokens[1] << reset << '\n';
-                    }
-                    else
-                    {
-                        Diagnose(i, "Label " + red + tokens[1] + reset + " was not found in the entire file at all... what are you doing??\n");
-                    }
-                }
-                else if (tokens[0] == "jmp")
-                {
-                    i = ToInt(tokens[1]);
-                }
-                else if (tokens[0] == "return" || tokens[0] == "goback")
-                {
-                    if (goneto_stack.empty())
-                    {
-                        Diagnose(i, "You have not gone anywhere before you go back... idiot\n");
-                    }
-                    else
-                    {
-                        Jump last_jump = goneto_stack.back();
-                        goneto_stack.erase(goneto_stack.end() - 1);
-                        i = last_jump.line_number;
-                        yesbug << "Jumping back to #" << green << i + 2 << reset << " (after " << green << last_jump.name << reset << ")" << '\n';
-                    }
-                }
-                else if (tokens[0] == "scan" || tokens[0] == "beg")
-                {
-                    size_t varloc = WhereVar(tokens[1]);
-                    if (varloc == (size_t)-1)
-                    {
-                        Diagnose(i, "Well how many freaking times do I have to tell you that variable " + red + tokens[1] + reset + " does not exist for scanning?? What a jerk...\n");
-                    }
-                    else
+
+                    OPCODE(obliterate)
                     {
-                        Variable &var = variables[varloc];
-                        int value_int = 0;
-                        float value_float = 0;
-                        char value_char = 0;
-                        switch (var.type)
+                        size_t varloc = instruction->operands[0];
+                        if (!variables[varloc].live)
                         {
-                            case Variable::_int:
-                                std::cin >> value_int;
-                                var.value_int = value_int;
-                                break;
-                            case Variable::_float:
-                                std::cin >> value_float;
-                                var.value_float = value_float;
-                                break;
-                            case Variable::_char:
-                                std::cin >> value_char;
-                                var.value_char = value_char;
-                                break;
-                            case Variable::_string:
-                                std::getline(std::cin, var.value_string);
-                                break;
+                            Diagnose(instruction->line, Witch::no_variable, symbols.names[varloc], "Damn... Variable " + symbols.names[varloc] + " does not exist for deletion\n");
                         }
-                    }
-                }
-                else if (tokens[0] == "print" || tokens[0] == "seg")
-                {
-                    size_t varloc = WhereVar(tokens[1]);
-                    if (varloc == (size_t)-1)
-                    {
-                        Diagnose(i, "Hell no I am not repeating this again... Variable " + red + tokens[1] + reset + " does not exist for printing\n");
-                    }
-                    else
-                    {
-                        Variable &var = variables[varloc];
-                        switch (var.type)
+                        else
                         {
-                            case Variable::_int:
-                                std::cout << var.value_int;
-                                break;
-                            case Variable::_float:
-                                std::cout << var.value_float;
-                                break;
-                            case Variable::_char:
-                                std::cout << var.value_char;
-                                break;
-                            case Variable::_string:
-                                std::cout << var.value_string;
-                                break;
+                            // The slot stays, only the variable in it goes
+                            variables[varloc] = Variable {};
                         }
+                        NEXT();
                     }
-                }
-                else if (tokens[0] == "delete" || tokens[0] == "obliterate" || tokens[0] == "explode")
-                {
-                    size_t varloc = WhereVar(tokens[1]);
-                    if (varloc == (size_t)-1)
-                    {
-                        Diagnose(i, "Damn... Variable " + tokens[1] + " does not exist for deletion\n");
-                    }
-                    else
-                    {
-                        variables.erase(variables.begin() + varloc);
-                    }
-                }
-                else if (tokens[0] == "branch")
-                {
-                    size_t varloc = WhereVar(tokens[1]);
-                    if (varloc == (size_t)-1)
-                    {
-                        Diagnose(i, "Oof... Variable " + tokens[1] + " does not exist for branching\n");
-                    }
-                    else
+
+                    OPCODE(branch)
                     {
+                        size_t varloc = instruction->operands[0];
+                        if (!variables[varloc].live)
+                        {
+                            Diagnose(instruction->line, Witch::no_variable, symbols.names[varloc], "Oof... Variable " + symbols.names[varloc] + " does not exist for branching\n");
+                            NEXT();
+                        }
                         bool do_jump = false;
                         switch (variables[varloc].type)
                         {
                             case Variable::_int:
-                                do_jump = variables[varloc].value_int != 0;
+                                do_jump = variables[varloc].as_int() != 0;
                                 break;
                             case Variable::_float:
-                                do_jump = variables[varloc].value_int != 0.0f;
+                                do_jump = variables[varloc].as_int() != 0.0f;
                                 break;
                             case Variable::_char:
-                                do_jump = variables[varloc].value_int != ' ';
+                                do_jump = variables[varloc].as_int() != ' ';
                                 break;
                             case Variable::_string:
-                                do_jump = variables[varloc].value_string != "";
+                                do_jump = variables[varloc].as_string() != "";
                                 break;
                         }
                         if (do_jump)
                         {
-                            bool found_label = false;
-                            for (size_t j = 0; j < lines.size(); j++)
-                            {
-                                std::vector<std::string> jump_tokens = tokenize(lines[j]);
-                                if (jump_tokens.empty()) continue;
-                                if (jump_tokens[1] == ":")
-                                {
-                                    if (tokens[2] == jump_tokens[0])
-                                    {
-                                        found_label = true;
-                                        i = j;
-                                    }
-                                }
-                            }
-                            if (found_label)
+                            size_t labelloc = instruction->target;
+                            if (labelloc != (size_t)-1)
                             {
-                                yesbug << "Branching to " << green << tokens[2] << reset << '\n';
+                                i = labelloc;
+                                yesbug << "Branching to " << green << instruction->text << reset << '\n';
+                                if (jit_compiler.enabled) i = jit_compiler.enter(i, variables.data());
                             }
                             else
                             {
-                                Diagnose(i, "Label " + red + tokens[2] + reset + " was not found in the entire file at all to be branched... like how the heck are you...\n");
+                                Diagnose(instruction->line, Witch::no_label, instruction->text, "Label " + red + instruction->text + reset + " was not found in the entire file at all to be branched... like how the heck are you...\n");
                             }
                         }
+                        NEXT();
                     }
-                }
-                else if (tokens[0] == "exists")
-                {
-                    size_t varloc = WhereVar(tokens[1]);
-                    if (varloc != (size_t)-1)
-                    {
-                        bool found_label = false;
-                        for (size_t j = 0; j < lines.size(); j++)
+
+                    OPCODE(exists)
+                        if (variables[instruction->operands[0]].live)
                         {
-                            std::vector<std::string> jump_tokens = tokenize(lines[j]);
-                            if (jump_tokens.empty()) continue;
-                            if (jump_tokens[1] == ":")
+                            size_t labelloc = instruction->target;
+                            if (labelloc != (size_t)-1)
                             {
-                                if (tokens[2] == jump_tokens[0])
-                                {
-                                    found_label = true;
-                                    i = j;
-                                }
+                                i = labelloc;
+                                yesbug << "Branching to " << green << instruction->text << reset << '\n';
+                                if (jit_compiler.enabled) i = jit_compiler.enter(i, variables.data());
                             }
-                        }
-                        if (found_label)
-                        {
-                            yesbug << "Branching to " << green << tokens[2] << reset << '\n';
-                        }
-                        else
-                        {
-                            Diagnose(i, "Label " + red + tokens[2] + reset + " was not found in the entire file at all to be branched... like how the heck are you...\n");
-                        }
-                    }
-                }
-                else if (tokens[0] == "exists")
-                {
-                    size_t varloc = WhereVar(tokens[1]);
-                    if (varloc != (size_t)-1)
-                    {
-                        bool found_label = false;
-                        for (size_t j = 0; j < lines.size(); j++)
-                        {
-                            std::vector<std::string> jump_tokens = tokenize(lines[j]);
-                            if (jump_tokens.empty()) continue;
-                            if (jump_tokens[1] == ":")
+                            else
                             {
-                                if (tokens[2] == jump_tokens[0])
-                                {
-                                    found_label = true;
-                                    i = j;
-                                }
+                                Diagnose(instruction->line, Witch::no_label, instruction->text, "Label " + red + instruction->text + reset + " was not found in the entire file at all to be branched... like how the heck are you...\n");
                             }
                         }
-                        if (found_label)
+                        NEXT();
+
+                    OPCODE(make_local)
+                        if (goneto_stack.empty())
                         {
-                            yesbug << "Branching to " << green << tokens[2] << reset << '\n';
+                            Diagnose(instruction->line, Witch::not_called, symbols.names[instruction->operands[0]], "Local to what?? Nobody called this, so " + red + symbols.names[instruction->operands[0]] + reset + " is just a normal variable\n");
                         }
-                        else
+                        else if (!goneto_stack.local(instruction->operands[0], variables.data()))
                         {
-                            Diagnose(i, "Label " + red + tokens[2] + reset + " was not found in the entire file at all to be branched... like how the heck are you...\n");
+                            Diagnose(instruction->line, Witch::too_many_locals, symbols.names[instruction->operands[0]], "Every call together already has " + red + std::to_string(MAX_FRAME_LOCALS) + reset + " locals, " + red + symbols.names[instruction->operands[0]] + reset + " has to make do with being a normal variable\n");
                         }
-                    }
-                }
-                else if (tokens[0] == "exit" || tokens[0] == "escape_the_torture")
-                {
-                    if (!variables.empty()) variables.clear();
-                    break;
-                }
-                else if (tokens[1] != ":")
-                {
-                    size_t varloc = WhereVar(tokens[0]);
-                    if (varloc == (size_t)-1)
-                    {
-                        Diagnose(i, "That's it. I am done. Variable " + red + bold + underline + tokens[0] + reset + " never existed (or is deleted now) but you decided to use it anyways. I am gone\n");
-                        std::cout << "Quitting...\n";
-                        ProgressCity(11 - 7.0f, 5.0f);
-                        break;
-                    }
-                    else
+                        NEXT();
+
+                    OPCODE(escape)
+                        for (Variable &variable : variables) variable = Variable {};
+                        goto finished;
+
+                    OPCODE(assign_copy)
+                    OPCODE(assign_not)
+                    OPCODE(assign_binary)
+                    OPCODE(assign_nothing)
+                    OPCODE(assign_wdym)
+                    generic_assign:
                     {
-                        if (tokens[1] != "=")
+                        size_t varloc = instruction->operands[0];
+                        if (!variables[varloc].live)
                         {
-                            Diagnose(i, "Wdym by that??\n");
+                            Diagnose(instruction->line, Witch::gone_for_good, symbols.names[varloc], "That's it. I am done. Variable " + red + bold + underline + symbols.names[varloc] + reset + " never existed (or is deleted now) but you decided to use it anyways. I am gone\n");
+                            std::cout << "Quitting...\n";
+                            if (!batch) ProgressCity(11 - 7.0f, 5.0f);
+                            goto finished;
                         }
-                        else
+                        if (instruction->opcode == Opcode::assign_wdym)
                         {
-                            size_t var_left = (size_t)-1;
-                            size_t var_right = (size_t)-1;
-                            size_t var_mid = (size_t)-1;
-                            if (tokens.size() > 2) var_left = WhereVar(tokens[2]);
-                            if (tokens.size() > 4) var_right = WhereVar(tokens[4]);
-                            if (tokens.size() > 3) var_mid = WhereVar(tokens[3]);
-                            auto RequestL = [&]() -> bool {
-                                if (var_left == (size_t)-1)
-                                {
-                                    Diagnose(i, "Variable... uff, " + red + tokens[2] + reset + " does not exist... yey");
-                                    return false;
-                                }
-                                return true;
-                            };
-                            auto RequestR = [&]() -> bool {
-                                if (var_right == (size_t)-1)
-                                {
-                                    Diagnose(i, "Variable... uff, " + red + tokens[4] + reset + " does not exist... yey");
-                                    return false;
-                                }
-                                return true;
-                            };
-                            auto RequestM = [&]() -> bool {
-                                if (var_mid == (size_t)-1)
-                                {
-                                    Diagnose(i, "Variable... uff, " + red + tokens[3] + reset + " does not exist... yey");
-                                    return false;
-                                }
-                                return true;
-                            };
-                            auto RequestLR = [&]() -> bool {
-                                return RequestL() && RequestR();
-                            };
+                            Diagnose(instruction->line, Witch::wdym, "", "Wdym by that??\n");
+                            NEXT();
+                        }
 
-                            if (tokens.size() == 3)
+                        size_t var_left = instruction->operands[1];
+                        size_t var_right = instruction->operands[2];
+                        auto RequestL = [&]() -> bool {
+                            if (!variables[var_left].live)
                             {
-                                switch (variables[varloc].type)
-                                {
-                                    case Variable::_int:
-                                        variables[varloc].value_int = variables[var_left].value_int;
-                                        break;
-                                    case Variable::_float:
-                                        variables[varloc].value_float = variables[var_left].value_float;
-                                        break;
-                                    case Variable::_char:
-                                        variables[varloc].value_char = variables[var_left].value_char;
-                                        break;
-                                    case Variable::_string:
-                                        variables[varloc].value_string = variables[var_left].value_string;
-                                        break;
-                                }
+                                Diagnose(instruction->line, Witch::no_variable, symbols.names[var_left], "Variable... uff, " + red + symbols.names[var_left] + reset + " does not exist... yey");
+                                return false;
                             }
-                            else if (tokens[2] == "!")
+                            return true;
+                        };
+                        auto RequestR = [&]() -> bool {
+                            if (!variables[var_right].live)
                             {
-                                if (RequestM())
-                                {
-                                    switch (variables[varloc].type)
-                                    {
-                                        case Variable::_int:
-                                            variables[varloc].value_int = !variables[var_mid].value_int;
-                                            break;
-                                        case Variable::_float:
-                                            variables[varloc].value_float = !variables[var_mid].value_float;
-                                            break;
-                                        case Variable::_char:
-                                            variables[varloc].value_char = !variables[var_mid].value_char;
-                                            break;
-                                        case Variable::_string:
-                                            Diagnose(i, "What do you mean by noting a string from another string??");
-                                            break;
-                                    }
-                                }
+                                Diagnose(instruction->line, Witch::no_variable, symbols.names[var_right], "Variable... uff, " + red + symbols.names[var_right] + reset + " does not exist... yey");
+                                return false;
                             }
-                            else if (tokens[3] == "+")
+                            return true;
+                        };
+                        auto RequestLR = [&]() -> bool {
+                            return RequestL() && RequestR();
+                        };
+
+                        Variable &dest = variables[varloc];
+                        if (instruction->opcode == Opcode::assign_copy)
+                        {
+                            if (!RequestL()) NEXT();
+                            const Variable &source = variables[var_left];
+                            switch (dest.type)
                             {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                case Variable::_int:
+                                    dest.value_int = source.as_int();
+                                    break;
+                                case Variable::_float:
+                                    dest.value_float = source.as_float();
+                                    break;
+                                case Variable::_char:
+                                    dest.value_char = source.as_char();
+                                    break;
+                                case Variable::_string:
+                                    dest.set_string(source.as_string());
+                                    break;
+                            }
+                        }
+                        else if (instruction->opcode == Opcode::assign_not)
+                        {
+                            if (!RequestL()) NEXT();
+                            const Variable &source = variables[var_left];
+                            switch (dest.type)
+                            {
+                                case Variable::_int:
+                                    dest.value_int = !source.as_int();
+                                    break;
+                                case Variable::_float:
+                                    dest.value_float = !source.as_float();
+                                    break;
+                                case Variable::_char:
+                                    dest.value_char = !source.as_char();
+                                    break;
+                                case Variable::_string:
+                                    Diagnose(instruction->line, Witch::string_math, "", "What do you mean by noting a string from another string??");
+                                    break;
+                            }
+                        }
+                        else if (instruction->operation != 0)
+                        {
+                            if (!RequestLR()) NEXT();
+                            const Variable &left = variables[var_left];
+                            const Variable &right = variables[var_right];
+                            switch (instruction->operation)
+                            {
+                                case '+':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int + variables[var_right].value_int;
+                                            dest.value_int = left.as_int() + right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = variables[var_left].value_float + variables[var_right].value_float;
+                                            dest.value_float = left.as_float() + right.as_float();
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char + variables[var_right].value_char;
+                                            dest.value_char = left.as_char() + right.as_char();
                                             break;
                                         case Variable::_string:
-                                            variables[varloc].value_string = variables[var_left].value_string + variables[var_right].value_string;
+                                            dest.set_string(std::string(left.as_string()) + std::string(right.as_string()));
                                             break;
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "-")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '-':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int - variables[var_right].value_int;
+                                            dest.value_int = left.as_int() - right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = variables[var_left].value_float - variables[var_right].value_float;
+                                            dest.value_float = left.as_float() - right.as_float();
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char - variables[var_right].value_char;
+                                            dest.value_char = left.as_char() - right.as_char();
                                             break;
                                         case Variable::_string:
-                                            variables[varloc].value_string = variables[var_left].value_string;
+                                        {
+                                            std::string result = std::string(left.as_string());
                                             size_t pos = 0;
-                                            while ((pos = variables[varloc].value_string.find(variables[var_right].value_string, pos)) != std::string::npos)
+                                            while ((pos = result.find(right.as_string(), pos)) != std::string::npos)
                                             {
-                                                variables[varloc].value_string.erase(pos, variables[var_right].value_string.length());
+                                                result.erase(pos, right.as_string().length());
                                             }
+                                            dest.set_string(result);
                                             break;
+                                        }
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "*")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '*':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int * variables[var_right].value_int;
+                                            dest.value_int = left.as_int() * right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = variables[var_left].value_float * variables[var_right].value_float;
+                                            dest.value_float = left.as_float() * right.as_float();
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char * variables[var_right].value_char;
+                                            dest.value_char = left.as_char() * right.as_char();
                                             break;
                                         case Variable::_string:
-                                            Diagnose(i, "What do you mean by multiplying a string from another string??");
+                                            Diagnose(instruction->line, Witch::string_math, "", "What do you mean by multiplying a string from another string??");
                                             break;
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "/")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '/':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int / variables[var_right].value_int;
+                                            dest.value_int = left.as_int() / right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = variables[var_left].value_float / variables[var_right].value_float;
+                                            dest.value_float = left.as_float() / right.as_float();
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char / variables[var_right].value_char;
+                                            dest.value_char = left.as_char() / right.as_char();
                                             break;
                                         case Variable::_string:
-                                            Diagnose(i, "What do you mean by dividing a string from another string??");
+                                            Diagnose(instruction->line, Witch::string_math, "", "What do you mean by dividing a string from another string??");
                                             break;
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "%")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '%':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int % variables[var_right].value_int;
+                                            dest.value_int = left.as_int() % right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = std::fmod(variables[var_left].value_float, variables[var_right].value_float);
+                                            dest.value_float = std::fmod(left.as_float(), right.as_float());
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char % variables[var_right].value_char;
+                                            dest.value_char = left.as_char() % right.as_char();
                                             break;
                                         case Variable::_string:
-                                            Diagnose(i, "What do you mean by modulating a string from another string??");
+                                            Diagnose(instruction->line, Witch::string_math, "", "What do you mean by modulating a string from another string??");
                                             break;
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "^")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '^':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = std::pow(variables[var_left].value_int, variables[var_right].value_int);
+                                            dest.value_int = std::pow(left.as_int(), right.as_int());
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = std::pow(variables[var_left].value_float, variables[var_right].value_float);
+                                            dest.value_float = std::pow(left.as_float(), right.as_float());
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = std::pow(variables[var_left].value_char, variables[var_right].value_char);
+                                            dest.value_char = std::pow(left.as_char(), right.as_char());
                                             break;
                                         case Variable::_string:
-                                            Diagnose(i, "What do you mean by exponentiating a string from another string??");
+                                            Diagnose(instruction->line, Witch::string_math, "", "What do you mean by exponentiating a string from another string??");
                                             break;
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "&")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '&':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int && variables[var_right].value_int;
+                                            dest.value_int = left.as_int() && right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = variables[var_left].value_float && variables[var_right].value_float;
+                                            dest.value_float = left.as_float() && right.as_float();
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char && variables[var_right].value_char;
+                                            dest.value_char = left.as_char() && right.as_char();
                                             break;
                                         case Variable::_string:
-                                            Diagnose(i, "What do you mean by anding a string from another string??");
+                                            Diagnose(instruction->line, Witch::string_math, "", "What do you mean by anding a string from another string??");
                                             break;
                                     }
-                                }
-                            }
-                            else if (tokens[3] == "|")
-                            {
-                                if (RequestLR())
-                                {
-                                    switch (variables[varloc].type)
+                                    break;
+                                case '|':
+                                    switch (dest.type)
                                     {
                                         case Variable::_int:
-                                            variables[varloc].value_int = variables[var_left].value_int || variables[var_right].value_int;
+                                            dest.value_int = left.as_int() || right.as_int();
                                             break;
                                         case Variable::_float:
-                                            variables[varloc].value_float = variables[var_left].value_float || variables[var_right].value_float;
+                                            dest.value_float = left.as_float() || right.as_float();
                                             break;
                                         case Variable::_char:
-                                            variables[varloc].value_char = variables[var_left].value_char || variables[var_right].value_char;
+                                            dest.value_char = left.as_char() || right.as_char();
                                             break;
                                         case Variable::_string:
-                                            Diagnose(i, "What do you mean by oring a string from another string??");
+                                            Diagnose(instruction->line, Witch::string_math, "", "What do you mean by oring a string from another string??");
                                             break;
                                     }
-                                }
+                                    break;
                             }
                         }
+                        NEXT();
+                    }
+
+                    OPCODE(add_int)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_int) || !left.holds(Variable::_int) || !right.holds(Variable::_int)) goto generic_assign;
+                        dest.value_int = left.value_int + right.value_int;
+                        NEXT();
+                    }
+
+                    OPCODE(sub_int)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_int) || !left.holds(Variable::_int) || !right.holds(Variable::_int)) goto generic_assign;
+                        dest.value_int = left.value_int - right.value_int;
+                        NEXT();
+                    }
+
+                    OPCODE(mul_int)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_int) || !left.holds(Variable::_int) || !right.holds(Variable::_int)) goto generic_assign;
+                        dest.value_int = left.value_int * right.value_int;
+                        NEXT();
+                    }
+
+                    OPCODE(div_int)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_int) || !left.holds(Variable::_int) || !right.holds(Variable::_int)) goto generic_assign;
+                        dest.value_int = left.value_int / right.value_int;
+                        NEXT();
+                    }
+
+                    OPCODE(mod_int)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_int) || !left.holds(Variable::_int) || !right.holds(Variable::_int)) goto generic_assign;
+                        dest.value_int = left.value_int % right.value_int;
+                        NEXT();
+                    }
+
+                    OPCODE(add_float)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_float) || !left.holds(Variable::_float) || !right.holds(Variable::_float)) goto generic_assign;
+                        dest.value_float = left.value_float + right.value_float;
+                        NEXT();
+                    }
+
+                    OPCODE(sub_float)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_float) || !left.holds(Variable::_float) || !right.holds(Variable::_float)) goto generic_assign;
+                        dest.value_float = left.value_float - right.value_float;
+                        NEXT();
+                    }
+
+                    OPCODE(mul_float)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_float) || !left.holds(Variable::_float) || !right.holds(Variable::_float)) goto generic_assign;
+                        dest.value_float = left.value_float * right.value_float;
+                        NEXT();
+                    }
+
+                    OPCODE(div_float)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_float) || !left.holds(Variable::_float) || !right.holds(Variable::_float)) goto generic_assign;
+                        dest.value_float = left.value_float / right.value_float;
+                        NEXT();
+                    }
+
+                    OPCODE(concat_string)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        const Variable &left = variables[instruction->operands[1]];
+                        const Variable &right = variables[instruction->operands[2]];
+                        if (!dest.holds(Variable::_string) || !left.holds(Variable::_string) || !right.holds(Variable::_string)) goto generic_assign;
+                        dest.set_string(std::string(left.as_string()).append(right.as_string()));
+                        NEXT();
+                    }
+
+                    OPCODE(assign_constant)
+                    {
+                        Variable &dest = variables[instruction->operands[0]];
+                        if (!dest.holds(instruction->constant.type)) goto generic_assign;
+                        dest = instruction->constant;
+                        NEXT();
+                    }
+
+                    OPCODE(finish)
+                    {
+                        goto finished;
+                    }
+#if !THREADED_DISPATCH
                     }
                 }
+#endif
             }
             catch (std::exception e)
             {
                 yesbug << "Invalid syntax or smth, " << red << e.what() << reset << '\n';
             }
         }
-        ifile.close();
+    finished:;
+#undef OPCODE
+#undef NEXT
+        if (profiling) profiler.finish(lines);
+    }
+
+    if (profiling && !waited && !profiler.write(profile_path))
+    {
+        std::cout << "Couldn't even write " << red << profile_path << reset << ". All that counting for nothing\n";
+    }
+
+    // Anything wrong with the files this process ran itself
+    bool complained = missing_files || std::any_of(witch_counts.begin(), witch_counts.end(), [](size_t count) { return count != 0; });
+
+    // A worker's witches go to the parent, which says the summary for everyone
+    if (only != (size_t)-1)
+    {
+        workers->report(witch_counts.data());
+        return complained ? 1 : 0;
+    }
+
+    // One last line so CI doesn't have to count the witches itself
+    if (batch)
+    {
+        size_t total = 0;
+        std::cerr << "{\"summary\":{";
+        for (size_t k = 0; k < (size_t)Witch::count; k++)
+        {
+            total += witch_counts[k];
+            std::cerr << (k ? "," : "") << '"' << witch_names[k] << "\":" << witch_counts[k];
+        }
+        std::cerr << "},\"total\":" << total << ",\"files\":" << filenames.size() << "}\n";
     }
+    if (waited) return workers->status();
+    // --jobs fails the run on any complaint whether it forked or not (one file, or nowhere to fork), plain runs stay as forgiving as ever
+    return jobs && complained ? 1 : 0;
 }
+#endif